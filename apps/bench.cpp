@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <line_sweep.hpp>
+#include <new>
+#include <random>
+#include <vector>
+
+// Per-run latency of many independent sweeps over small inputs, comparing a
+// fresh LineSweep per run against one LineSweep reused through reset().
+//
+// Usage: bench [segments per run] [runs]
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocations++;
+    std::size_t alignment = static_cast<std::size_t>(align);
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+static std::vector<std::vector<segment_t>> make_inputs(std::size_t n, std::size_t count) {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> coord(0, 100), delta(-20, 20);
+
+    std::vector<std::vector<segment_t>> inputs(count);
+    for (auto& segs : inputs) {
+        for (std::size_t i = 0; i < n; i++) {
+            double x = coord(gen), y = coord(gen);
+            segs.emplace_back(x, y, x + delta(gen), y + delta(gen));
+        }
+    }
+    return inputs;
+}
+
+template <typename Run>
+static void report(const char* name, const std::vector<std::vector<segment_t>>& inputs, Run run) {
+    // Warm up so that reused capacity reaches its steady state
+    for (const auto& segs : inputs) run(segs);
+
+    std::size_t found = 0, allocations_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto& segs : inputs) found += run(segs);
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::size_t runs = inputs.size();
+
+    std::cout << name << ": " << elapsed.count() / runs << " us/run, "
+              << double(allocations - allocations_before) / runs << " allocations/run, "
+              << double(found) / runs << " intersections/run\n";
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::atoi(argv[1]) : 64;
+    std::size_t runs = argc > 2 ? std::atoi(argv[2]) : 2000;
+    auto inputs = make_inputs(n, runs);
+
+    std::cout << runs << " runs of " << n << " segments\n";
+
+    report("fresh LineSweep", inputs, [](const std::vector<segment_t>& segs) {
+        LineSweep sweep(segs);
+        sweep.find_intersections();
+        return sweep.intersectionCount();
+    });
+
+    LineSweep reused;
+    report("reused LineSweep", inputs, [&](const std::vector<segment_t>& segs) {
+        reused.reset(segs);
+        reused.find_intersections();
+        return reused.intersectionCount();
+    });
+
+    HeapLineSweep reused_heap;
+    report("reused HeapLineSweep", inputs, [&](const std::vector<segment_t>& segs) {
+        reused_heap.reset(segs);
+        reused_heap.find_intersections();
+        return reused_heap.intersectionCount();
+    });
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace DS {
+
+// Monotonic memory resource that keeps its chunks across release(). Like
+// std::pmr::monotonic_buffer_resource it bumps through chunks and ignores
+// deallocation, but release() only rewinds to the first chunk, so a run that
+// fits in the memory of earlier runs makes no upstream allocation at all.
+// Chunks go back upstream when the resource is destroyed.
+class arena_resource : public std::pmr::memory_resource {
+    struct chunk_t {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    std::pmr::memory_resource* _upstream;
+    std::vector<chunk_t> _chunks;
+    std::size_t _current = 0;  // Chunk being bumped through
+    std::size_t _offset = 0;   // First free byte in it
+    std::size_t _next_size;
+
+    static constexpr std::size_t _chunk_align = alignof(std::max_align_t);
+
+    void* _bump(std::size_t bytes, std::size_t alignment) {
+        chunk_t& chunk = _chunks[_current];
+
+        void* ptr = chunk.data + _offset;
+        std::size_t space = chunk.size - _offset;
+        if (std::align(alignment, bytes, ptr, space) == nullptr) return nullptr;
+
+        _offset = chunk.size - space + bytes;
+        return ptr;
+    }
+
+   protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        for (; _current < _chunks.size(); _current++, _offset = 0) {
+            if (void* ptr = _bump(bytes, alignment)) return ptr;
+        }
+
+        std::size_t size = std::max(_next_size, bytes + alignment);
+        _next_size = 2 * size;
+
+        _chunks.push_back({static_cast<std::byte*>(_upstream->allocate(size, _chunk_align)), size});
+        _current = _chunks.size() - 1;
+        _offset = 0;
+        return _bump(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+   public:
+    explicit arena_resource(std::size_t initial_size = 4096,
+                            std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : _upstream(upstream), _next_size(std::max<std::size_t>(initial_size, 64)) {}
+
+    arena_resource(const arena_resource&) = delete;
+    arena_resource& operator=(const arena_resource&) = delete;
+
+    ~arena_resource() override {
+        for (const auto& chunk : _chunks) _upstream->deallocate(chunk.data, chunk.size, _chunk_align);
+    }
+
+    // Invalidates everything allocated so far, keeping the chunks for reuse
+    void release() {
+        _current = 0;
+        _offset = 0;
+    }
+
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const auto& chunk : _chunks) total += chunk.size;
+        return total;
+    }
+};
+
+}  // namespace DS
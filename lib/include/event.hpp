@@ -1,8 +1,10 @@
 #pragma once
 
-#include <comparable_segment.hpp>
 #include <line_segment.hpp>
+#include <memory_resource>
 #include <point.hpp>
+#include <segment_store.hpp>
+#include <small_vector.hpp>
 #include <vector>
 
 using point_t = Geometry::Point;
@@ -11,13 +13,37 @@ using segment_t = Geometry::LineSegment;
 struct Event {
    private:
    public:
-    point_t* pt;
+    // Almost every list holds one or two segments, which then stay inline.
+    // Longer lists spill into the same memory resource as the Event itself.
+    using allocator_type = std::pmr::polymorphic_allocator<segment_id_t>;
+    using list_t = DS::small_vector<segment_id_t, 2, allocator_type>;
 
-    std::vector<ComparableSegment*> lower;
-    std::vector<ComparableSegment*> upper;
-    std::vector<ComparableSegment*> contain;
+    point_t pt;
 
-    Event(point_t* pt, ComparableSegment* seg, int type) : pt(pt) {
+    // Named after the Point order of the endpoints: segments whose lesser
+    // endpoint (u, met first by the sweep) is pt, whose greater endpoint (v)
+    // is pt, and that pass through pt in their interior.
+    list_t lower;
+    list_t upper;
+    list_t contain;
+
+    Event(const point_t& pt, segment_id_t seg, int type, const allocator_type& alloc = {})
+        : pt(pt), lower(alloc), upper(alloc), contain(alloc) {
+        add(seg, type);
+    }
+
+    bool empty() const { return lower.empty() and upper.empty() and contain.empty(); }
+
+    // Turns a spent event into a new one, keeping any spilled list storage
+    void reset(const point_t& new_pt, segment_id_t seg, int type) {
+        pt = new_pt;
+        lower.clear();
+        upper.clear();
+        contain.clear();
+        add(seg, type);
+    }
+
+    void add(segment_id_t seg, int type) {
         // TODO: Verify this THOROUGHLY
         switch (type) {
             case 0:
@@ -44,4 +70,29 @@ struct Event {
 
         return res;
     }
-};
\ No newline at end of file
+};
+
+// Hands out Events carved from a memory resource and takes back the ones the
+// sweep is done with, so that a sweep needs only as many Events as are
+// alive at once rather than one per event point it ever sees. Events are
+// never freed, the owner releases them with the resource after clear().
+class EventPool {
+    std::pmr::polymorphic_allocator<> _alloc;
+    std::vector<Event*> _free;
+
+   public:
+    explicit EventPool(std::pmr::memory_resource* resource) : _alloc(resource) {}
+
+    Event* make(const point_t& pt, segment_id_t seg, int type) {
+        if (_free.empty()) return _alloc.new_object<Event>(pt, seg, type);
+
+        Event* e = _free.back();
+        _free.pop_back();
+        e->reset(pt, seg, type);
+        return e;
+    }
+
+    void recycle(Event* e) { _free.push_back(e); }
+
+    void clear() { _free.clear(); }
+};
@@ -1,21 +1,66 @@
 #pragma once
 
 #include <event.hpp>
+#include <memory_resource>
 #include <rb_tree.hpp>
+#include <utility>
+#include <vector>
 
+// Events are carved out of the memory resource given at construction and are
+// never freed by the queue. Those handed back through recycle() or discarded
+// are reused for later events, the owner releases them all with the resource.
 struct EventQueue {
     using container_t = DS::rb_tree::tree_t<point_t, Event*>;
-    using node_t = DS::rb_tree::node_t<point_t, Event*>;
+    using iterator = container_t::iterator;
+    explicit EventQueue(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : _pool(resource) {}
 
-    void insert(const point_t& pt, Event* e);
+    struct endpoint_t {
+        point_t pt;
+        segment_id_t seg;
+        int type;
+    };
+
+    // Fills events with the endpoint events of all segments sorted by point,
+    // coincident endpoints merged. Both vectors are cleared first and keep
+    // their capacity, so repeated builds do not allocate.
+    static void endpoint_events(const SegmentStore& segments, EventPool& pool,
+                                std::vector<endpoint_t>& endpoints, std::vector<std::pair<point_t, Event*>>& events);
+
+    // Bulk loads the endpoint events of all segments in O(n log n) for the
+    // sort plus O(n) for the tree. Queue must be empty.
+    void build(const SegmentStore& segments);
+
+    // Returns the event held by the queue for pt. A segment is appended to an
+    // existing event in place, an Event is only allocated for a new point.
+    Event* insert(const point_t& pt, segment_id_t seg, int type);
     void erase(const point_t& pt);
+
+    // Drops an event that has been emptied before it was handled
+    void discard(Event* e) {
+        erase(e->pt);
+        _pool.recycle(e);
+    }
+
     Event* next();
 
-    node_t* search(const point_t& pt) { return _container.search(pt); }
-    node_t* end() { return _container.end(); }
+    // Takes back an event returned by next() once it has been handled
+    void recycle(Event* e) { _pool.recycle(e); }
+
+    iterator search(const point_t& pt) { return _container.search(pt); }
+    iterator end() { return _container.end(); }
 
     bool empty() { return _container.size() == 0; }
 
+    // Forgets every event, they are owned by the memory resource
+    void clear() {
+        _container.clear();
+        _pool.clear();
+    }
+
    private:
+    EventPool _pool;
     container_t _container;
+
+    std::vector<endpoint_t> _endpoints;  // Scratch space for build
+    std::vector<std::pair<point_t, Event*>> _events;
 };
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+namespace DS {
+
+// Single pass input range over the values a coroutine co_yields. The
+// coroutine only runs when the consumer asks for the next value, and is
+// destroyed with the generator, so stopping early abandons the rest of its
+// work. Yielded values are handed out by reference and live until the
+// consumer advances.
+template <typename T>
+class generator : public std::ranges::view_interface<generator<T>> {
+   public:
+    struct promise_type {
+        const T* value = nullptr;
+        std::exception_ptr exception;
+
+        generator get_return_object() { return generator{handle_t::from_promise(*this)}; }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(const T& val) noexcept {
+            value = std::addressof(val);
+            return {};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        // Generators only yield
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+    };
+
+    using handle_t = std::coroutine_handle<promise_type>;
+
+    class iterator {
+       public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(handle_t handle) : _handle(handle) {}
+
+        const T& operator*() const { return *_handle.promise().value; }
+
+        iterator& operator++() {
+            _resume(_handle);
+            return *this;
+        }
+
+        void operator++(int) { ++(*this); }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) { return !it._handle or it._handle.done(); }
+
+       private:
+        handle_t _handle{};
+    };
+
+    generator() = default;
+
+    generator(generator&& other) noexcept : _handle(std::exchange(other._handle, {})) {}
+
+    generator& operator=(generator&& other) noexcept {
+        if (this != &other) {
+            if (_handle) _handle.destroy();
+            _handle = std::exchange(other._handle, {});
+        }
+        return *this;
+    }
+
+    ~generator() {
+        if (_handle) _handle.destroy();
+    }
+
+    // Runs the coroutine up to its first value, call only once
+    iterator begin() {
+        if (_handle) _resume(_handle);
+        return iterator{_handle};
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+   private:
+    handle_t _handle{};
+
+    explicit generator(handle_t handle) : _handle(handle) {}
+
+    static void _resume(handle_t handle) {
+        handle.resume();
+        if (handle.done() and handle.promise().exception) std::rethrow_exception(handle.promise().exception);
+    }
+};
+
+}  // namespace DS
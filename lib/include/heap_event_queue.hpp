@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <event.hpp>
+#include <event_queue.hpp>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// Event queue for a sweep whose endpoints are all known up front. Endpoint
+// events sit in a presorted array consumed by a cursor, and only the
+// intersections discovered during the sweep go into a D-ary min heap.
+// Duplicate intersection events are not searched for on insert, they are
+// merged when they reach the top. Discarded events stay behind as tombstones
+// that are skipped on pop, and the heap is compacted once they make up half
+// of it. Events are owned by the memory resource and recycled as in
+// EventQueue, a discarded one once it has left the heap.
+struct HeapEventQueue {
+    static constexpr std::size_t D = 4;
+
+    explicit HeapEventQueue(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : _pool(resource) {}
+
+    void build(const SegmentStore& segments);
+
+    Event* insert(const point_t& pt, segment_id_t seg, int type);
+    void discard(Event* e);
+    Event* next();
+    void recycle(Event* e) { _pool.recycle(e); }
+
+    // Tombstones may remain, next() returns nullptr once only they are left
+    bool empty() { return _cursor == _endpoints.size() and _heap.size() == _tombstones; }
+
+    // Forgets every event, they are owned by the memory resource
+    void clear();
+
+   private:
+    EventPool _pool;
+
+    std::vector<EventQueue::endpoint_t> _sorted;  // Scratch space for build
+    std::vector<std::pair<point_t, Event*>> _endpoints;
+    std::size_t _cursor = 0;
+
+    std::vector<Event*> _heap;
+    std::size_t _tombstones = 0;
+
+    Event* _pop_heap();
+    void _compact();
+    void _sift_up(std::size_t idx);
+    void _sift_down(std::size_t idx);
+};
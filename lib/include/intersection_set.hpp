@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <point.hpp>
+#include <segment_store.hpp>
+#include <span>
+#include <vector>
+
+using point_t = Geometry::Point;
+
+// One reported intersection, viewing into the IntersectionSet it came from
+struct Intersection {
+    point_t pt;
+    std::span<const segment_id_t> ids;  // Indices into the input of the sweep
+};
+
+// Intersections in compressed sparse row form: the points in one array, and
+// the segment ids of all of them in another, where those of intersection i
+// are ids()[offsets()[i], offsets()[i + 1]). Three flat arrays in total,
+// whatever the number of intersections, which can be written out or handed
+// to other consumers as they are. clear() keeps their capacity.
+class IntersectionSet {
+   public:
+    using offset_t = std::uint64_t;
+
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Intersection;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Intersection;
+
+        iterator() = default;
+        iterator(const IntersectionSet* set, std::size_t idx) : _set(set), _idx(idx) {}
+
+        Intersection operator*() const { return (*_set)[_idx]; }
+
+        iterator& operator++() {
+            _idx++;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res{*this};
+            ++(*this);
+            return res;
+        }
+
+        friend bool operator==(const iterator& lhs, const iterator& rhs) { return lhs._idx == rhs._idx; }
+
+       private:
+        const IntersectionSet* _set{nullptr};
+        std::size_t _idx{0};
+    };
+
+    // Starts a new intersection at pt, append() adds its segments
+    void push_back(const point_t& pt) {
+        _points.push_back(pt);
+        _offsets.push_back(_offsets.back());
+    }
+
+    template <typename It>
+    void append(It first, It last) {
+        _ids.insert(_ids.end(), first, last);
+        _offsets.back() = _ids.size();
+    }
+
+    void reserve(std::size_t count, std::size_t ids) {
+        _points.reserve(count);
+        _offsets.reserve(count + 1);
+        _ids.reserve(ids);
+    }
+
+    void clear() {
+        _points.clear();
+        _offsets.assign(1, 0);
+        _ids.clear();
+    }
+
+    std::size_t size() const { return _points.size(); }
+    bool empty() const { return _points.empty(); }
+
+    Intersection operator[](std::size_t idx) const {
+        return {_points[idx], std::span<const segment_id_t>(_ids).subspan(_offsets[idx], _offsets[idx + 1] - _offsets[idx])};
+    }
+
+    iterator begin() const { return {this, 0}; }
+    iterator end() const { return {this, size()}; }
+
+    std::span<const point_t> points() const { return _points; }
+    std::span<const offset_t> offsets() const { return _offsets; }  // size() + 1 entries
+    std::span<const segment_id_t> ids() const { return _ids; }
+
+   private:
+    std::vector<point_t> _points;
+    std::vector<offset_t> _offsets{0};
+    std::vector<segment_id_t> _ids;
+};
@@ -1,30 +1,202 @@
 #pragma once
 
+#include <arena_resource.hpp>
+#include <atomic>
+#include <chrono>
+#include <concepts>
 #include <event_queue.hpp>
+#include <generator.hpp>
+#include <heap_event_queue.hpp>
+#include <intersection_set.hpp>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <segment_store.hpp>
+#include <span>
 #include <status.hpp>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 constexpr double EPS = 1e-9;  // TODO: Try other numbers
 
-struct Intersection {
-    point_t pt;
-    std::vector<ComparableSegment> segs;
+// Number of intersection points, and of intersecting pairs of segments, the
+// latter summing C(m, 2) over the m segments through each point. In a
+// red-blue sweep only points with both colors and red-blue pairs count.
+struct IntersectionCounts {
+    std::size_t points = 0;
+    std::size_t pairs = 0;
 };
 
-class LineSweep {
-    double sweep_line_y;
+struct SweepOptions {
+    // Keep at most one pending intersection event per pair of neighbours in
+    // the Status, cancelling it when the pair is separated. Bounds the event
+    // queue at O(n) instead of O(n + k), at the cost of re-finding events
+    // for pairs that become neighbours again.
+    bool adjacent_pairs_only = false;
 
-    EventQueue q;
+    // Promise for a red-blue sweep that segments of the same color never
+    // cross in their interiors, as in a planar layer, though they may touch
+    // at shared vertices, T-junctions or collinear overlaps. Same color
+    // neighbours are then never checked for an intersection, so the work
+    // depends on the red-blue intersections only, and touching segments are
+    // still picked up from the Status at each event point. Without it same
+    // color crossings have to be found to keep the Status in order, just
+    // not reported.
+    bool colors_noncrossing = false;
+
+    // Budget for one run. Once either is used up the sweep stops early and
+    // reports the result as truncated.
+    std::size_t max_intersections = std::numeric_limits<std::size_t>::max();
+    std::chrono::steady_clock::duration time_limit = std::chrono::steady_clock::duration::max();
+
+    // Events between two looks at the clock and the stop token
+    std::size_t check_every = 64;
+};
+
+// Snapshot of a running sweep, safe to take from any thread
+struct SweepProgress {
+    std::size_t events = 0;         // Event points handled
+    std::size_t intersections = 0;  // Intersections found
+    double fraction = 0;            // Position of the sweep line in the y range of the input, 0 at the top
+};
+
+// Queue is EventQueue (a red black tree keyed by point) or HeapEventQueue
+// (presorted endpoints plus a heap of intersections). Both are instantiated
+// in line_sweep.cpp.
+//
+// Segments must not be horizontal, which SegmentStore asserts. Collinear
+// segments that overlap are reported at both ends of the overlap, where one
+// starts or ends on the other, and together at any point where another
+// segment crosses them.
+//
+// Segments are held in a SegmentStore and referred to by their index in the
+// input, results are collected in an IntersectionSet. Events live in an
+// arena owned by the sweep and are released together when it is destroyed
+// or reset. A reset keeps the arena chunks, tree node pools and vectors, so
+// a sweep object that is reused for inputs of similar size runs without
+// touching the heap.
+template <typename Queue = EventQueue>
+class BasicLineSweep {
+    SweepLine sweep_line;
+    SweepOptions options;
+
+    DS::arena_resource arena;  // Declared before everything carved from it
+    SegmentStore segments;
+    Queue q;
     Status status;
-    std::vector<ComparableSegment*> segments;
-    std::vector<Intersection> intersections;
+    IntersectionSet results;
+
+    // Where handleEventPoint reports to, the IntersectionSet if neither is set
+    struct sink_t {
+        void* ctx = nullptr;
+        void (*call)(void* ctx, const Intersection& intersection) = nullptr;
+    } sink;
+
+    // Points the sink at a consumer for its own lifetime, so that it is
+    // cleared however the run ends, by returning or by an exception
+    struct sink_guard {
+        sink_t& sink;
+
+        sink_guard(sink_t& sink, sink_t to) : sink(sink) { sink = to; }
+        ~sink_guard() { sink = {}; }
+    };
+
+    IntersectionCounts* counts = nullptr;
+    std::size_t reported = 0;  // Intersections found in this run
+    bool stopped_early = false;
+
+    // Extra reasons to stop, checked with the time budget
+    std::stop_token stop_token;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+    // Published by the event loop for progress()
+    double top_y = 0, bottom_y = 0;
+    std::atomic<std::size_t> handled_events = 0;
+    std::atomic<std::size_t> found_intersections = 0;
+    std::atomic<double> current_y = 0;
+    std::vector<segment_id_t> report_ids;  // Scratch space for the sink
+
+    void load(std::span<const segment_t> segments, std::span<const SegmentColor> colors);
+    bool run();
 
    public:
-    LineSweep(std::vector<segment_t>& segments);
-    void find_intersections();
+    BasicLineSweep(std::span<const segment_t> segments = {}, SweepOptions options = {});
+
+    // Red-blue sweep: colors[i] is the color of segments[i], and only
+    // points where segments of both colors meet are reported. The ids of
+    // such a point name every segment through it, of either color, with or
+    // without colors_noncrossing.
+    BasicLineSweep(std::span<const segment_t> segments, std::span<const SegmentColor> colors, SweepOptions options = {});
+
+    // Drops all segments, events and results and rewinds the arena
+    void reset();
+
+    // Starts over on a new input, retaining all allocated capacity
+    void reset(std::span<const segment_t> segments);
+    void reset(std::span<const segment_t> segments, std::span<const SegmentColor> colors);
+    // Returns false if the budget in SweepOptions cut the sweep short
+    bool find_intersections();
+
+    // Also stops early once a stop is requested through stop or the
+    // deadline passes, both checked every SweepOptions::check_every events
+    bool find_intersections(std::stop_token stop, std::chrono::steady_clock::time_point deadline);
+
+    // Runs find_intersections() with the worker's stop token on a new
+    // thread. Leave the sweep alone until the thread has been joined, then
+    // read the results and truncated() as usual. Destroying the thread
+    // requests a stop and joins it, so the thread must be kept.
+    // progress() may be polled meanwhile.
+    [[nodiscard]] std::jthread find_intersections_async(
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    SweepProgress progress() const;
+
+    // Hands each intersection to visit as soon as it is found instead of
+    // collecting it, so memory does not grow with their number. The ids of
+    // the Intersection passed to visit are only valid during the call.
+    template <typename Visitor>
+        requires std::invocable<Visitor&, const Intersection&>
+    bool find_intersections(Visitor&& visit) {
+        using visitor_t = std::remove_reference_t<Visitor>;
+
+        sink_guard guard(sink, {const_cast<void*>(static_cast<const void*>(std::addressof(visit))),
+                                [](void* ctx, const Intersection& intersection) { (*static_cast<visitor_t*>(ctx))(intersection); }});
+        return run();
+    }
+
+    // Only counts the intersections, in memory linear in the number of
+    // segments. Always runs with adjacent_pairs_only, see truncated().
+    IntersectionCounts count_intersections();
+
+    // Runs the sweep lazily, one event point at a time as the consumer
+    // pulls the next intersection, so that stopping early abandons the rest
+    // of the work. Nothing is collected, and the ids of a yielded
+    // Intersection are valid until the consumer advances. The budget in
+    // SweepOptions does not apply.
+    DS::generator<Intersection> intersections();
+
+    // Shamos-Hoey: whether any two segments touch or cross, in O(n log n).
+    // Only endpoint events are processed, and the sweep stops at the first
+    // pair found, which it returns. Leaves the sweep midway, reset it before
+    // running it again.
+    std::optional<std::pair<segment_id_t, segment_id_t>> find_any_intersection();
     void handleEventPoint(Event* e);
 
-    void findNewEvent(ComparableSegment* left, ComparableSegment* right, point_t* pt);
+    void findNewEvent(segment_id_t left, segment_id_t right, const point_t& pt);
+    void cancelEvent(segment_id_t left, segment_id_t right, const point_t& pt);
+
+    // Valid until the sweep is reset or destroyed, copy what must outlive it
+    const IntersectionSet& getIntersections() const { return results; }
+    std::size_t intersectionCount() const { return results.size(); }
 
-    std::vector<Intersection> getIntersections() { return intersections; }
+    // Whether the last run stopped at its budget with events left, so that
+    // there may be intersections it did not report
+    bool truncated() const { return stopped_early; }
 };
+
+using LineSweep = BasicLineSweep<EventQueue>;
+using HeapLineSweep = BasicLineSweep<HeapEventQueue>;
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace DS {
+
+// Free-list slab pool for fixed size objects (tree nodes).
+// Single objects are carved out of contiguous chunks of ChunkSize slots and
+// recycled through an intrusive free list, so steady state insert/erase does
+// not touch the global heap. Memory is returned only when the pool dies.
+template <typename T, std::size_t ChunkSize = 256>
+class pool_allocator {
+    union slot_t {
+        slot_t* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<slot_t[]>> _chunks;
+    slot_t* _free = nullptr;  // Head of the free list
+
+    void _grow() {
+        _chunks.emplace_back(new slot_t[ChunkSize]);
+        slot_t* chunk = _chunks.back().get();
+
+        for (std::size_t i = 0; i + 1 < ChunkSize; i++)
+            chunk[i].next = &chunk[i + 1];
+
+        chunk[ChunkSize - 1].next = _free;
+        _free = chunk;
+    }
+
+   public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = pool_allocator<U, ChunkSize>;
+    };
+
+    pool_allocator() = default;
+
+    // Pools are never shared, copies start out empty
+    pool_allocator(const pool_allocator&) noexcept {}
+    template <typename U>
+    pool_allocator(const pool_allocator<U, ChunkSize>&) noexcept {}
+
+    pool_allocator& operator=(const pool_allocator&) noexcept { return *this; }
+
+    T* allocate(std::size_t n) {
+        if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+
+        if (_free == nullptr) _grow();
+
+        slot_t* slot = _free;
+        _free = slot->next;
+        return reinterpret_cast<T*>(slot->storage);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (n != 1) {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+            return;
+        }
+
+        slot_t* slot = reinterpret_cast<slot_t*>(p);
+        slot->next = _free;
+        _free = slot;
+    }
+
+    std::size_t capacity() const noexcept { return _chunks.size() * ChunkSize; }
+
+    friend bool operator==(const pool_allocator& lhs, const pool_allocator& rhs) noexcept { return &lhs == &rhs; }
+};
+
+}  // namespace DS
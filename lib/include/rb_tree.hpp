@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstddef>
+#include <iterator>
+#include <memory>
+#include <pool_allocator.hpp>
+#include <utility>
 
 namespace DS {
 namespace rb_tree {
@@ -22,37 +26,147 @@ struct node_t {
     bool is_leaf() noexcept;
 };
 
-template <typename K, typename V>
+// Three way comparison through the keys' own operator<=>
+struct three_way {
+    template <typename L, typename R>
+    auto operator()(const L &lhs, const R &rhs) const {
+        return lhs <=> rhs;
+    }
+};
+
+// Compare is called as comp(lhs, rhs) and returns a value that compares
+// against 0 like the result of <=>. It may carry state, e.g. a reference to
+// the position of a sweep line, which is stored once in the tree.
+//
+// Alloc hands out node_t<K, V> storage. The default pools nodes in contiguous
+// recycled chunks; pass std::allocator<node_t<K, V>> for plain new/delete.
+template <typename K, typename V, typename Compare = three_way, typename Alloc = pool_allocator<node_t<K, V>>>
 struct tree_t {
     using node_ptr_t = node_t<K, V> *;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
 
    private:
-    std::size_t _size = 0;              // Number of Elements in the Tree
-    node_ptr_t nil = new node_t<K, V>;  // Sentinel node_ptr_t
-    node_ptr_t root{nil};               // Root node_ptr_t
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    [[no_unique_address]] Compare _comp;
+    Alloc _alloc;                     // Node storage, declared before any node
+    std::size_t _size = 0;            // Number of Elements in the Tree
+    node_ptr_t nil = _create_node();  // Sentinel node_ptr_t
+    node_ptr_t root{nil};             // Root node_ptr_t
+
+    // Header links to the extreme nodes, kept up to date by insert and _delete
+    node_ptr_t _leftmost{nil};
+    node_ptr_t _rightmost{nil};
+
+    node_ptr_t _create_node();
+    void _destroy_node(node_ptr_t);
+    void _destroy_subtree(node_ptr_t);
 
     node_ptr_t _minimum(node_ptr_t);
+    node_ptr_t _maximum(node_ptr_t);
+    node_ptr_t _successor(node_ptr_t);
+    node_ptr_t _predecessor(node_ptr_t);
 
     void _transplant(node_ptr_t, node_ptr_t);
     void _delete(node_ptr_t);
     void _delete_fixup(node_ptr_t);
 
+    template <typename It>
+    node_ptr_t _build(It first, std::size_t n, node_ptr_t parent, std::size_t depth, std::size_t red_depth);
+
     void _left_rotate(node_ptr_t);
     void _right_rotate(node_ptr_t);
     void _insert_fixup(node_ptr_t);
 
+    // Hangs z below y (on the given side) and rebalances
+    void _link(node_ptr_t z, node_ptr_t y, bool left);
+
    public:
-    node_ptr_t minimum() { return _minimum(root); }
-    node_ptr_t search(K key);
-    node_ptr_t upper_bound(K key);
-    node_ptr_t lower_bound(K key);
-    node_ptr_t insert(K key, V val);
+    // Bidirectional in-order iterator over the nodes. end() wraps around, so
+    // --end() is the maximum and --begin() is end(). Iterators stay valid until
+    // the node they refer to is erased.
+    struct iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = node_t<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = node_ptr_t;
+        using reference = node_t<K, V> &;
+
+        iterator() = default;
+        iterator(node_ptr_t node, tree_t *tree) : _node(node), _tree(tree) {}
+
+        reference operator*() const { return *_node; }
+        pointer operator->() const { return _node; }
+        pointer node() const { return _node; }
+
+        iterator &operator++() {
+            _node = _tree->_successor(_node);
+            return *this;
+        }
+
+        iterator &operator--() {
+            _node = (_node == _tree->nil) ? _tree->_rightmost : _tree->_predecessor(_node);
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res{*this};
+            ++(*this);
+            return res;
+        }
+
+        iterator operator--(int) {
+            iterator res{*this};
+            --(*this);
+            return res;
+        }
+
+        friend bool operator==(const iterator &lhs, const iterator &rhs) { return lhs._node == rhs._node; }
+
+       private:
+        node_ptr_t _node{nullptr};
+        tree_t *_tree{nullptr};
+    };
+
+    tree_t() = default;
+    explicit tree_t(const Compare &comp) : _comp(comp) {}
+    tree_t(const tree_t &) = delete;
+    tree_t &operator=(const tree_t &) = delete;
+    ~tree_t();
+
+    iterator minimum() { return {_leftmost, this}; }
+    iterator maximum() { return {_rightmost, this}; }
+    iterator search(K key);
+    iterator upper_bound(K key);
+    iterator lower_bound(K key);
+    iterator insert(K key, V val);
+
+    // Single descent: calls merge(val) on the node whose key equals key if
+    // there is one, otherwise links a new node holding make()
+    template <typename Make, typename Merge>
+    iterator insert_or_merge(const K &key, Make make, Merge merge);
     void erase(K key);
 
+    // Unlinks the node directly, returns the iterator following it
+    iterator erase(iterator pos);
+
+    // Unlinks the minimum node without searching for it. Tree must be non empty.
+    V pop_min();
+
+    // Builds a balanced tree in O(n) from n (key, val) pairs with strictly
+    // increasing keys, replacing the current contents. Tree must be empty.
+    template <typename It>
+    void build(It first, std::size_t n);
+
     std::size_t size() { return _size; }
-    node_ptr_t end() { return nil; }
+    const Compare &key_comp() const { return _comp; }
+
+    // Removes every node, returning them to the allocator
+    void clear();
 
-    // TODO: Forward and Backward Traversal
+    iterator begin() { return {_leftmost, this}; }
+    iterator end() { return {nil, this}; }
 };
 
 }  // namespace rb_tree
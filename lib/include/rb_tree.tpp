@@ -3,8 +3,44 @@
 namespace DS {
 namespace rb_tree {
 
-template <typename K, typename V>
-void tree_t<K, V>::_left_rotate(node_ptr_t x) {
+template <typename K, typename V, typename Compare, typename Alloc>
+node_t<K, V> *tree_t<K, V, Compare, Alloc>::_create_node() {
+    node_ptr_t z = alloc_traits::allocate(_alloc, 1);
+    alloc_traits::construct(_alloc, z);
+    return z;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_destroy_node(node_ptr_t z) {
+    alloc_traits::destroy(_alloc, z);
+    alloc_traits::deallocate(_alloc, z, 1);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_destroy_subtree(node_ptr_t x) {
+    // Recursion depth is bounded by the height of the tree
+    if (x == nil) return;
+    _destroy_subtree(x->left);
+    _destroy_subtree(x->right);
+    _destroy_node(x);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+tree_t<K, V, Compare, Alloc>::~tree_t() {
+    _destroy_subtree(root);
+    _destroy_node(nil);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::clear() {
+    _destroy_subtree(root);
+
+    root = _leftmost = _rightmost = nil;
+    _size = 0;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_left_rotate(node_ptr_t x) {
     node_ptr_t y = x->right;
     x->right = y->left;
 
@@ -26,8 +62,8 @@ void tree_t<K, V>::_left_rotate(node_ptr_t x) {
     x->p = y;
 }
 
-template <typename K, typename V>
-void tree_t<K, V>::_right_rotate(node_ptr_t y) {
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_right_rotate(node_ptr_t y) {
     node_ptr_t x = y->left;
     y->left = x->right;
 
@@ -49,31 +85,72 @@ void tree_t<K, V>::_right_rotate(node_ptr_t y) {
     y->p = x;
 }
 
-template <typename K, typename V>
-node_t<K, V> *tree_t<K, V>::insert(K key, V val) {
-    node_ptr_t z = new node_t<K, V>;
+template <typename K, typename V, typename Compare, typename Alloc>
+typename tree_t<K, V, Compare, Alloc>::iterator tree_t<K, V, Compare, Alloc>::insert(K key, V val) {
+    node_ptr_t x = root, y = nil;
+    bool left = false;
+
+    while (x != nil) {
+        y = x;
+        left = _comp(key, x->key) < 0;
+        if (left)
+            x = x->left;
+        else
+            x = x->right;
+    }
+
+    node_ptr_t z = _create_node();
     z->key = key;
     z->val = val;
 
+    _link(z, y, left);
+    return {z, this};
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+template <typename Make, typename Merge>
+typename tree_t<K, V, Compare, Alloc>::iterator tree_t<K, V, Compare, Alloc>::insert_or_merge(const K &key, Make make, Merge merge) {
     node_ptr_t x = root, y = nil;
+    bool left = false;
 
     while (x != nil) {
+        auto cmp = _comp(key, x->key);
+        if (cmp == 0) {
+            merge(x->val);
+            return {x, this};
+        }
+
         y = x;
-        if (key < x->key)
+        left = cmp < 0;
+        if (left)
             x = x->left;
         else
             x = x->right;
     }
 
+    node_ptr_t z = _create_node();
+    z->key = key;
+    z->val = make();
+
+    _link(z, y, left);
+    return {z, this};
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_link(node_ptr_t z, node_ptr_t y, bool left) {
     z->p = y;
 
-    if (y == nil)
+    if (y == nil) {
         root = z;
-    else {
-        if (z->key < y->key)
+        _leftmost = _rightmost = z;
+    } else {
+        if (left) {
             y->left = z;
-        else
+            if (y == _leftmost) _leftmost = z;
+        } else {
             y->right = z;
+            if (y == _rightmost) _rightmost = z;
+        }
     }
 
     z->left = nil;
@@ -83,11 +160,10 @@ node_t<K, V> *tree_t<K, V>::insert(K key, V val) {
     _insert_fixup(z);
 
     ++_size;
-    return z;
 }
 
-template <typename K, typename V>
-void tree_t<K, V>::_insert_fixup(node_ptr_t z) {
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_insert_fixup(node_ptr_t z) {
     while (z->p->color == Color::RED) {
         if (z->p == z->p->p->left) {
             node_ptr_t y = z->p->p->right;
@@ -128,34 +204,69 @@ void tree_t<K, V>::_insert_fixup(node_ptr_t z) {
     root->color = Color::BLACK;
 }
 
-template <typename K, typename V>
-node_t<K, V> *tree_t<K, V>::_minimum(node_ptr_t x) {
+template <typename K, typename V, typename Compare, typename Alloc>
+node_t<K, V> *tree_t<K, V, Compare, Alloc>::_minimum(node_ptr_t x) {
     while (x->left != nil) {
         x = x->left;
     }
     return x;
 }
 
-template <typename K, typename V>
-node_t<K, V> *tree_t<K, V>::search(K key) {
+template <typename K, typename V, typename Compare, typename Alloc>
+node_t<K, V> *tree_t<K, V, Compare, Alloc>::_maximum(node_ptr_t x) {
+    while (x->right != nil) {
+        x = x->right;
+    }
+    return x;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+node_t<K, V> *tree_t<K, V, Compare, Alloc>::_successor(node_ptr_t x) {
+    if (x->right != nil) return _minimum(x->right);
+
+    node_ptr_t y = x->p;
+    while (y != nil && x == y->right) {
+        x = y;
+        y = y->p;
+    }
+    return y;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+node_t<K, V> *tree_t<K, V, Compare, Alloc>::_predecessor(node_ptr_t x) {
+    if (x->left != nil) return _maximum(x->left);
+
+    node_ptr_t y = x->p;
+    while (y != nil && x == y->left) {
+        x = y;
+        y = y->p;
+    }
+    return y;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+typename tree_t<K, V, Compare, Alloc>::iterator tree_t<K, V, Compare, Alloc>::search(K key) {
     node_ptr_t x = root;
-    while (x != nil && x->key != key) {
-        if (x->key > key) {
+    while (x != nil) {
+        auto cmp = _comp(key, x->key);
+        if (cmp == 0) break;
+
+        if (cmp < 0) {
             x = x->left;
         } else {
             x = x->right;
         }
     }
-    return x;
+    return {x, this};
 }
 
-template <typename K, typename V>
-node_t<K, V> *tree_t<K, V>::upper_bound(K key) {
+template <typename K, typename V, typename Compare, typename Alloc>
+typename tree_t<K, V, Compare, Alloc>::iterator tree_t<K, V, Compare, Alloc>::upper_bound(K key) {
     node_ptr_t x = root;
     node_ptr_t upper_bound = nil;
 
     while (x != nil) {
-        if (x->key <= key) {
+        if (_comp(x->key, key) <= 0) {
             x = x->right;
         } else {
             upper_bound = x;
@@ -163,16 +274,16 @@ node_t<K, V> *tree_t<K, V>::upper_bound(K key) {
         }
     }
 
-    return upper_bound;
+    return {upper_bound, this};
 }
 
-template <typename K, typename V>
-node_t<K, V> *tree_t<K, V>::lower_bound(K key) {
+template <typename K, typename V, typename Compare, typename Alloc>
+typename tree_t<K, V, Compare, Alloc>::iterator tree_t<K, V, Compare, Alloc>::lower_bound(K key) {
     node_ptr_t x = root;
     node_ptr_t lower_bound = nil;
 
     while (x != nil) {
-        if (x->key < key) {
+        if (_comp(x->key, key) < 0) {
             x = x->right;
         } else {
             lower_bound = x;
@@ -180,11 +291,11 @@ node_t<K, V> *tree_t<K, V>::lower_bound(K key) {
         }
     }
 
-    return lower_bound;
+    return {lower_bound, this};
 }
 
-template <typename K, typename V>
-void tree_t<K, V>::_transplant(node_ptr_t u, node_ptr_t v) {
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_transplant(node_ptr_t u, node_ptr_t v) {
     if (u->p == nil)
         root = v;
 
@@ -197,8 +308,12 @@ void tree_t<K, V>::_transplant(node_ptr_t u, node_ptr_t v) {
     v->p = u->p;
 }
 
-template <typename K, typename V>
-void tree_t<K, V>::_delete(node_ptr_t z) {
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_delete(node_ptr_t z) {
+    // Nodes are relinked rather than copied, so neighbours found now stay valid
+    if (z == _leftmost) _leftmost = _successor(z);
+    if (z == _rightmost) _rightmost = _predecessor(z);
+
     node_ptr_t y = z;
     Color y_original_color = y->color;
 
@@ -230,14 +345,14 @@ void tree_t<K, V>::_delete(node_ptr_t z) {
         y->color = z->color;
     }
 
-    delete z;
+    _destroy_node(z);
 
     if (y_original_color == Color::BLACK)
         _delete_fixup(x);
 }
 
-template <typename K, typename V>
-void tree_t<K, V>::_delete_fixup(node_ptr_t x) {
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::_delete_fixup(node_ptr_t x) {
     node_ptr_t w;
     while (x != root && x->color == Color::BLACK) {
         if (x == x->p->left) {
@@ -298,13 +413,70 @@ void tree_t<K, V>::_delete_fixup(node_ptr_t x) {
     x->color = Color::BLACK;
 }
 
-template <typename K, typename V>
-void tree_t<K, V>::erase(K key) {
-    node_ptr_t dNode = search(key);
+template <typename K, typename V, typename Compare, typename Alloc>
+void tree_t<K, V, Compare, Alloc>::erase(K key) {
+    node_ptr_t dNode = search(key).node();
     if (dNode == nil) return;
     _delete(dNode);
     _size--;
 }
 
+template <typename K, typename V, typename Compare, typename Alloc>
+typename tree_t<K, V, Compare, Alloc>::iterator tree_t<K, V, Compare, Alloc>::erase(iterator pos) {
+    node_ptr_t dNode = pos.node();
+    node_ptr_t next = _successor(dNode);
+
+    _delete(dNode);
+    _size--;
+    return {next, this};
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+template <typename It>
+node_t<K, V> *tree_t<K, V, Compare, Alloc>::_build(It first, std::size_t n, node_ptr_t parent, std::size_t depth, std::size_t red_depth) {
+    if (n == 0) return nil;
+
+    // Splitting at the middle keeps all leaves within one level of each
+    // other, so colouring only the deepest level red balances black heights
+    std::size_t mid = (n - 1) / 2;
+    It it = std::next(first, mid);
+
+    node_ptr_t z = _create_node();
+    z->key = it->first;
+    z->val = it->second;
+    z->p = parent;
+    z->color = (depth == red_depth) ? Color::RED : Color::BLACK;
+
+    z->left = _build(first, mid, z, depth + 1, red_depth);
+    z->right = _build(std::next(it), n - mid - 1, z, depth + 1, red_depth);
+    return z;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+template <typename It>
+void tree_t<K, V, Compare, Alloc>::build(It first, std::size_t n) {
+    if (n == 0) return;
+
+    std::size_t red_depth = 0;  // floor(log2(n)), the deepest level
+    while ((std::size_t{2} << red_depth) <= n) red_depth++;
+
+    root = _build(first, n, nil, 0, red_depth);
+    root->color = Color::BLACK;
+
+    _leftmost = _minimum(root);
+    _rightmost = _maximum(root);
+    _size = n;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc>
+V tree_t<K, V, Compare, Alloc>::pop_min() {
+    node_ptr_t min = _leftmost;
+    V res = std::move(min->val);
+
+    _delete(min);
+    _size--;
+    return res;
+}
+
 }  // namespace rb_tree
 }  // namespace DS
\ No newline at end of file
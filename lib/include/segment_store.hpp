@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <line_segment.hpp>
+#include <point.hpp>
+#include <rb_tree.hpp>
+#include <span>
+#include <vector>
+
+// oEUv
+
+struct Event;
+
+using point_t = Geometry::Point;
+using segment_t = Geometry::LineSegment;
+
+// Position of the sweep line. Every move starts a new epoch, which
+// invalidates the positions memoised in the SweepKeys.
+struct SweepLine {
+    double y = 0;
+    std::uint64_t epoch = 1;
+
+    void move_to(double new_y) {
+        y = new_y;
+        epoch++;
+    }
+};
+
+// Line through a segment in the form the Status compares. Where it crosses
+// a horizontal line is one subtraction and one fused multiply add away,
+// instead of the division compute_intersection does. The reference point is
+// the lower endpoint, so the x there is exact.
+struct SweepKey {
+    double x = 0, y = 0;  // Reference point
+    double dxdy = 0;      // Inverse slope, 0 for a vertical line
+
+    SweepKey() = default;
+
+    SweepKey(double x, double y, double dxdy = 0) : x(x), y(y), dxdy(dxdy) {}
+
+    double x_at(double sweep_line_y) const { return std::fma(dxdy, sweep_line_y - y, x); }
+
+    // Memoised for the current epoch, a key in the Status is evaluated at
+    // most once per position of the sweep line however often it is compared
+    double x_at(const SweepLine& line) const {
+        if (_epoch != line.epoch) {
+            _x = x_at(line.y);
+            _epoch = line.epoch;
+        }
+        return _x;
+    }
+
+   private:
+    mutable double _x = 0;
+    mutable std::uint64_t _epoch = 0;
+};
+
+using segment_id_t = std::uint32_t;
+
+// Layer of a segment in a red-blue sweep
+enum class SegmentColor : std::uint8_t {
+    red,
+    blue
+};
+
+// Segments of one sweep, referred to everywhere else by their index in the
+// input. Coordinates, precomputed slopes and the per segment sweep state
+// each live in their own contiguous array. assign() keeps the capacity of
+// all of them, so a store reused for inputs of similar size does not
+// allocate.
+class SegmentStore {
+   public:
+    using handle_t = DS::rb_tree::node_t<SweepKey, segment_id_t>*;
+
+    static constexpr segment_id_t npos = std::numeric_limits<segment_id_t>::max();
+
+    // Without colors every segment is red and the store is not colored()
+    void assign(std::span<const segment_t> segments, std::span<const SegmentColor> colors = {}) {
+        assert(segments.size() < npos);
+        assert(colors.empty() or colors.size() == segments.size());
+        clear();
+        for (auto array : {&_ux, &_uy, &_vx, &_vy, &_dxdy}) array->reserve(segments.size());
+
+        for (const auto& seg : segments) {
+            assert(seg.u.y != seg.v.y);
+
+            _ux.push_back(seg.u.x);
+            _uy.push_back(seg.u.y);
+            _vx.push_back(seg.v.x);
+            _vy.push_back(seg.v.y);
+            _dxdy.push_back((seg.v.x - seg.u.x) / (seg.v.y - seg.u.y));
+        }
+
+        _node.assign(segments.size(), nullptr);
+        _pending.assign(segments.size(), nullptr);
+
+        _colored = !colors.empty();
+        if (_colored)
+            _color.assign(colors.begin(), colors.end());
+        else
+            _color.assign(segments.size(), SegmentColor::red);
+    }
+
+    void clear() {
+        for (auto array : {&_ux, &_uy, &_vx, &_vy, &_dxdy}) array->clear();
+        _node.clear();
+        _pending.clear();
+        _color.clear();
+        _colored = false;
+    }
+
+    std::size_t size() const { return _ux.size(); }
+
+    point_t u(segment_id_t id) const { return point_t(_ux[id], _uy[id]); }
+    point_t v(segment_id_t id) const { return point_t(_vx[id], _vy[id]); }
+    segment_t segment(segment_id_t id) const { return segment_t(u(id), v(id)); }
+
+    // Status key, referenced at the lower endpoint
+    SweepKey key(segment_id_t id) const { return SweepKey(_vx[id], _vy[id], _dxdy[id]); }
+
+    // Node holding the segment while it is in the Status
+    handle_t& node(segment_id_t id) { return _node[id]; }
+
+    // Intersection event with its right neighbour, see SweepOptions
+    Event*& pending(segment_id_t id) { return _pending[id]; }
+
+    SegmentColor color(segment_id_t id) const { return _color[id]; }
+    bool colored() const { return _colored; }
+
+   private:
+    std::vector<double> _ux, _uy, _vx, _vy, _dxdy;
+    std::vector<handle_t> _node;
+    std::vector<Event*> _pending;
+    std::vector<SegmentColor> _color;
+    bool _colored = false;
+};
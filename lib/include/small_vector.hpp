@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace DS {
+
+// Vector of trivially copyable values that keeps up to N of them inline and
+// only spills to Alloc beyond that. The inline buffer shares storage with
+// the heap pointer, so small_vector<T*, 2> is as large as a std::vector.
+template <typename T, std::size_t N, typename Alloc = std::allocator<T>>
+class small_vector {
+    static_assert(std::is_trivially_copyable_v<T>, "small_vector only holds trivially copyable values");
+    static_assert(N > 0, "small_vector needs room for at least one inline value");
+
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    [[no_unique_address]] Alloc _alloc;
+    std::uint32_t _size = 0;
+    std::uint32_t _capacity = N;  // N while the values are inline
+
+    union {
+        T _inline[N];
+        T* _heap;
+    };
+
+    bool _is_inline() const { return _capacity == N; }
+
+    void _grow(std::size_t min_capacity) {
+        std::size_t capacity = std::max<std::size_t>(2 * _capacity, min_capacity);
+
+        T* heap = alloc_traits::allocate(_alloc, capacity);
+        std::memcpy(heap, data(), _size * sizeof(T));
+        _release();
+
+        _heap = heap;
+        _capacity = capacity;
+    }
+
+    void _release() {
+        if (!_is_inline()) alloc_traits::deallocate(_alloc, _heap, _capacity);
+        _capacity = N;
+    }
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    small_vector() = default;
+    explicit small_vector(const Alloc& alloc) : _alloc(alloc) {}
+
+    small_vector(const small_vector& other)
+        : _alloc(alloc_traits::select_on_container_copy_construction(other._alloc)) {
+        insert(end(), other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept : _alloc(other._alloc) {
+        *this = std::move(other);
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other) {
+            clear();
+            insert(end(), other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept {
+        if (this == &other) return *this;
+
+        if (other._is_inline() or !(_alloc == other._alloc)) {
+            clear();
+            insert(end(), other.begin(), other.end());
+            other.clear();
+            return *this;
+        }
+
+        // Steal the spilled buffer
+        _release();
+        _heap = other._heap;
+        _size = other._size;
+        _capacity = other._capacity;
+
+        other._size = 0;
+        other._capacity = N;
+        return *this;
+    }
+
+    ~small_vector() { _release(); }
+
+    T* data() { return _is_inline() ? _inline : _heap; }
+    const T* data() const { return _is_inline() ? _inline : _heap; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + _size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + _size; }
+
+    std::size_t size() const { return _size; }
+    std::size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    T& operator[](std::size_t idx) { return data()[idx]; }
+    const T& operator[](std::size_t idx) const { return data()[idx]; }
+
+    T& back() { return data()[_size - 1]; }
+    const T& back() const { return data()[_size - 1]; }
+
+    void reserve(std::size_t capacity) {
+        if (capacity > _capacity) _grow(capacity);
+    }
+
+    void push_back(const T& val) {
+        if (_size == _capacity) _grow(_size + 1);
+        data()[_size++] = val;
+    }
+
+    void pop_back() { --_size; }
+
+    void clear() { _size = 0; }
+
+    template <typename It>
+    iterator insert(const_iterator pos, It first, It last) {
+        std::size_t offset = pos - begin();
+        std::size_t count = std::distance(first, last);
+        if (_size + count > _capacity) _grow(_size + count);
+
+        T* at = data() + offset;
+        std::memmove(at + count, at, (_size - offset) * sizeof(T));
+        std::copy(first, last, at);
+
+        _size += count;
+        return at;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        T* at = begin() + (first - begin());
+        std::size_t count = last - first;
+
+        std::memmove(at, at + count, (end() - last) * sizeof(T));
+        _size -= count;
+        return at;
+    }
+};
+
+}  // namespace DS
@@ -1,32 +1,114 @@
 #pragma once
 
-#include <comparable_segment.hpp>
 #include <rb_tree.hpp>
+#include <segment_store.hpp>
+#include <utility>
 
 using point_t = Geometry::Point;
 using segment_t = Geometry::LineSegment;
 
+// Orders segments by where they cross the sweep line. The sweep position is
+// shared by every comparison, so it is referenced once here instead of from
+// every key.
+struct SweepCompare {
+    const SweepLine* sweep_line;
+
+    int operator()(const SweepKey& lhs, const SweepKey& rhs) const {
+        double lhs_x = lhs.x_at(*sweep_line);
+        double rhs_x = rhs.x_at(*sweep_line);
+
+        if (lhs_x < rhs_x)
+            return -1;
+        else if (lhs_x == rhs_x)
+            return 0;
+        else
+            return 1;
+    }
+};
+
+// Every segment in the Status has its node recorded in the SegmentStore, so
+// removal and neighbour lookups go straight to the node without comparing
+// any segments. Keys are copies of the segments' SweepKeys, so comparisons
+// never leave the node.
 struct Status {
-    using container_t = DS::rb_tree::tree_t<ComparableSegment, ComparableSegment*>;
+    using container_t = DS::rb_tree::tree_t<SweepKey, segment_id_t, SweepCompare>;
+    using iterator = container_t::iterator;
+
+    Status(const SweepLine* sweep_line, SegmentStore* segments)
+        : _segments(segments), _container(SweepCompare{sweep_line}) {}
 
-    void insert(ComparableSegment* seg) {
-        _container.insert(*seg, seg);
+    iterator insert(segment_id_t seg) {
+        auto it = _container.insert(_segments->key(seg), seg);
+        _segments->node(seg) = it.node();
+        return it;
     }
 
-    void erase(const ComparableSegment& seg) {
-        _container.erase(seg);
+    void erase(segment_id_t seg) {
+        _container.erase(handle(seg));
+        _segments->node(seg) = nullptr;
     }
 
-    ComparableSegment* lower_bound(const ComparableSegment& seg) {
-        return _container.lower_bound(seg)->val;
+    iterator handle(segment_id_t seg) { return {_segments->node(seg), &_container}; }
+
+    // Neighbours of a segment in the Status, SegmentStore::npos if there are none
+    segment_id_t left(segment_id_t seg) {
+        auto it = handle(seg);
+        return it == begin() ? SegmentStore::npos : std::prev(it)->val;
     }
 
-    ComparableSegment* upper_bound(const ComparableSegment& seg) {
-        return _container.upper_bound(seg)->val;
+    segment_id_t right(segment_id_t seg) {
+        auto it = std::next(handle(seg));
+        return it == end() ? SegmentStore::npos : it->val;
     }
 
-    ComparableSegment* next();
+    // Reverses the contiguous run of segments from first to last in place.
+    // Only payloads and handles move, the shape of the tree is unchanged.
+    void reverse(segment_id_t first, segment_id_t last) {
+        auto l = handle(first), r = handle(last);
+        while (l != r) {
+            std::swap(l->key, r->key);
+            std::swap(l->val, r->val);
+            _segments->node(l->val) = l.node();
+            _segments->node(r->val) = r.node();
+
+            if (++l == r) break;
+            --r;
+        }
+    }
+
+    // Whether the run from first to last is in order, together with the
+    // segments on either side of it, at the current sweep y
+    bool ordered(segment_id_t first, segment_id_t last) {
+        auto it = handle(first), stop = std::next(handle(last));
+        if (it != begin()) --it;
+        if (stop != end()) ++stop;
+
+        for (auto next = std::next(it); next != stop; it = next++) {
+            if (_container.key_comp()(next->key, it->key) < 0) return false;
+        }
+        return true;
+    }
+
+    iterator lower_bound(const SweepKey& key) {
+        return _container.lower_bound(key);
+    }
+
+    iterator upper_bound(const SweepKey& key) {
+        return _container.upper_bound(key);
+    }
+
+    // Whether lhs comes before rhs at the current sweep y. Both must be in
+    // the Status, whose keys hold the memoised positions.
+    bool less(segment_id_t lhs, segment_id_t rhs) {
+        return _container.key_comp()(handle(lhs)->key, handle(rhs)->key) < 0;
+    }
+
+    void clear() { _container.clear(); }
+
+    iterator begin() { return _container.begin(); }
+    iterator end() { return _container.end(); }
 
    private:
+    SegmentStore* _segments;
     container_t _container;
-};
\ No newline at end of file
+};
@@ -1,12 +1,39 @@
+#include <algorithm>
 #include <event_queue.hpp>
+#include <utility>
 
-void EventQueue::insert(const point_t& pt, Event* e) {
-    auto node_ptr = _container.search(pt);
-    if (node_ptr->key == pt) {
-        *(node_ptr->val) = *(node_ptr->val) | *e;  // Merge the events
-    } else {
-        _container.insert(pt, e);
+void EventQueue::endpoint_events(const SegmentStore& segments, EventPool& pool,
+                                 std::vector<endpoint_t>& endpoints, std::vector<std::pair<point_t, Event*>>& events) {
+    endpoints.clear();
+    endpoints.reserve(2 * segments.size());
+    for (segment_id_t seg = 0; seg < segments.size(); seg++) {
+        endpoints.push_back({segments.u(seg), seg, 0});
+        endpoints.push_back({segments.v(seg), seg, 1});
     }
+
+    std::sort(endpoints.begin(), endpoints.end(), [](const endpoint_t& lhs, const endpoint_t& rhs) { return lhs.pt < rhs.pt; });
+
+    // Coincident endpoints share one event
+    events.clear();
+    events.reserve(endpoints.size());
+    for (const auto& endpoint : endpoints) {
+        if (events.size() and events.back().first == endpoint.pt)
+            events.back().second->add(endpoint.seg, endpoint.type);
+        else
+            events.emplace_back(endpoint.pt, pool.make(endpoint.pt, endpoint.seg, endpoint.type));
+    }
+}
+
+void EventQueue::build(const SegmentStore& segments) {
+    endpoint_events(segments, _pool, _endpoints, _events);
+    _container.build(_events.begin(), _events.size());
+}
+
+Event* EventQueue::insert(const point_t& pt, segment_id_t seg, int type) {
+    auto make = [&]() { return _pool.make(pt, seg, type); };
+    auto merge = [&](Event* resident) { resident->add(seg, type); };
+
+    return _container.insert_or_merge(pt, make, merge)->val;
 }
 
 void EventQueue::erase(const point_t& pt) { _container.erase(pt); };
@@ -14,11 +41,5 @@ void EventQueue::erase(const point_t& pt) { _container.erase(pt); };
 Event* EventQueue::next() {
     if (_container.size() == 0) return nullptr;
 
-    auto min = _container.minimum();
-
-    // TODO: Verify if this actually works
-    auto res = std::move(min->val);  // Speed Moving >> Copying
-    _container.erase(min->key);
-
-    return res;
+    return _container.pop_min();
 }
\ No newline at end of file
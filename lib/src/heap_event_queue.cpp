@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <heap_event_queue.hpp>
+#include <utility>
+
+void HeapEventQueue::build(const SegmentStore& segments) {
+    EventQueue::endpoint_events(segments, _pool, _sorted, _endpoints);
+    _cursor = 0;
+}
+
+Event* HeapEventQueue::insert(const point_t& pt, segment_id_t seg, int type) {
+    Event* e = _pool.make(pt, seg, type);
+    _heap.push_back(e);
+    _sift_up(_heap.size() - 1);
+    return e;
+}
+
+void HeapEventQueue::discard(Event*) {
+    if (2 * ++_tombstones > _heap.size()) _compact();
+}
+
+void HeapEventQueue::clear() {
+    _endpoints.clear();
+    _cursor = 0;
+
+    _heap.clear();
+    _tombstones = 0;
+    _pool.clear();
+}
+
+Event* HeapEventQueue::next() {
+    while (!empty()) {
+        Event* res;
+        if (_heap.empty() or (_cursor < _endpoints.size() and !(_heap[0]->pt < _endpoints[_cursor].first)))
+            res = _endpoints[_cursor++].second;
+        else
+            res = _pop_heap();
+
+        // Intersections found more than once, or at an endpoint, surface together
+        while (_heap.size() and _heap[0]->pt == res->pt) {
+            Event* dup = _pop_heap();
+            res->contain.insert(res->contain.end(), dup->contain.begin(), dup->contain.end());
+            _pool.recycle(dup);
+        }
+
+        if (!res->empty()) return res;
+        _pool.recycle(res);
+    }
+
+    return nullptr;
+}
+
+Event* HeapEventQueue::_pop_heap() {
+    Event* top = _heap[0];
+    _heap[0] = _heap.back();
+    _heap.pop_back();
+
+    if (_heap.size()) _sift_down(0);
+    if (top->empty()) _tombstones--;
+    return top;
+}
+
+void HeapEventQueue::_compact() {
+    std::erase_if(_heap, [&](Event* e) {
+        if (!e->empty()) return false;
+        _pool.recycle(e);
+        return true;
+    });
+    _tombstones = 0;
+
+    if (_heap.size() < 2) return;
+    for (std::size_t idx = (_heap.size() - 2) / D + 1; idx-- > 0;) _sift_down(idx);
+}
+
+void HeapEventQueue::_sift_up(std::size_t idx) {
+    Event* e = _heap[idx];
+    while (idx > 0) {
+        std::size_t parent = (idx - 1) / D;
+        if (!(e->pt < _heap[parent]->pt)) break;
+
+        _heap[idx] = _heap[parent];
+        idx = parent;
+    }
+    _heap[idx] = e;
+}
+
+void HeapEventQueue::_sift_down(std::size_t idx) {
+    Event* e = _heap[idx];
+    const std::size_t n = _heap.size();
+
+    while (true) {
+        std::size_t first = D * idx + 1;
+        if (first >= n) break;
+
+        std::size_t last = std::min(first + D, n), min = first;
+        for (std::size_t child = first + 1; child < last; child++)
+            if (_heap[child]->pt < _heap[min]->pt) min = child;
+
+        if (!(_heap[min]->pt < e->pt)) break;
+
+        _heap[idx] = _heap[min];
+        idx = min;
+    }
+    _heap[idx] = e;
+}
@@ -25,8 +25,8 @@ bool onSegment(Geometry::Point p, Geometry::Point q, Geometry::Point r) {
 }
 
 int orientation(Point p, Point q, Point r) {
-    int val = (q.y - p.y) * (r.x - q.x) -
-              (q.x - p.x) * (r.y - q.y);
+    double val = (q.y - p.y) * (r.x - q.x) -
+                 (q.x - p.x) * (r.y - q.y);
 
     if (val == 0) return 0;    // collinear
     return (val > 0) ? 1 : 2;  // clock or counterclock wise
@@ -1,63 +1,274 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <iterator>
 #include <line_sweep.hpp>
+#include <utility>
 
-LineSweep::LineSweep(std::vector<segment_t>& segs) {
-    segments.reserve(segs.size());
+template <typename Queue>
+BasicLineSweep<Queue>::BasicLineSweep(std::span<const segment_t> segs, SweepOptions options)
+    : BasicLineSweep(segs, {}, options) {}
 
-    for (const auto& seg : segs) {
-        segments.push_back(new ComparableSegment(seg.u, seg.v, &sweep_line_y));
+template <typename Queue>
+BasicLineSweep<Queue>::BasicLineSweep(std::span<const segment_t> segs, std::span<const SegmentColor> colors, SweepOptions options)
+    : options(options),
+      arena(segs.size() * 2 * sizeof(Event)),
+      q(&arena),
+      status(&sweep_line, &segments) {
+    load(segs, colors);
+}
+
+template <typename Queue>
+void BasicLineSweep<Queue>::load(std::span<const segment_t> segs, std::span<const SegmentColor> colors) {
+    segments.assign(segs, colors);
+    q.build(segments);
+
+    top_y = bottom_y = 0;
+    if (segs.size()) {
+        top_y = std::max_element(segs.begin(), segs.end(), [](const auto& l, const auto& r) { return l.u.y < r.u.y; })->u.y;
+        bottom_y = std::min_element(segs.begin(), segs.end(), [](const auto& l, const auto& r) { return l.v.y < r.v.y; })->v.y;
     }
 
-    for (auto segment : segments) {
-        q.insert(segment->u, new Event(&segment->u, segment, 0));
-        q.insert(segment->v, new Event(&segment->v, segment, 1));
+    // Guess at one crossing per segment, which covers sparse inputs
+    results.reserve(segs.size(), 2 * segs.size());
+}
+
+template <typename Queue>
+void BasicLineSweep<Queue>::reset() {
+    q.clear();
+    status.clear();
+    segments.clear();
+
+    results.clear();
+    arena.release();
+}
+
+template <typename Queue>
+void BasicLineSweep<Queue>::reset(std::span<const segment_t> segs) {
+    reset();
+    load(segs, {});
+}
+
+template <typename Queue>
+void BasicLineSweep<Queue>::reset(std::span<const segment_t> segs, std::span<const SegmentColor> colors) {
+    reset();
+    load(segs, colors);
+}
+
+template <typename Queue>
+bool BasicLineSweep<Queue>::find_intersections() {
+    sink = {};
+    return run();
+}
+
+template <typename Queue>
+bool BasicLineSweep<Queue>::find_intersections(std::stop_token stop, std::chrono::steady_clock::time_point until) {
+    stop_token = std::move(stop);
+    deadline = until;
+    bool complete = find_intersections();
+
+    stop_token = {};
+    deadline = std::chrono::steady_clock::time_point::max();
+    return complete;
+}
+
+template <typename Queue>
+std::jthread BasicLineSweep<Queue>::find_intersections_async(std::chrono::steady_clock::time_point until) {
+    return std::jthread([this, until](std::stop_token stop) { find_intersections(std::move(stop), until); });
+}
+
+template <typename Queue>
+SweepProgress BasicLineSweep<Queue>::progress() const {
+    SweepProgress res;
+    res.events = handled_events.load(std::memory_order_relaxed);
+    res.intersections = found_intersections.load(std::memory_order_relaxed);
+
+    double height = top_y - bottom_y;
+    if (res.events and height > 0) res.fraction = std::clamp((top_y - current_y.load(std::memory_order_relaxed)) / height, 0.0, 1.0);
+    return res;
+}
+
+template <typename Queue>
+IntersectionCounts BasicLineSweep<Queue>::count_intersections() {
+    IntersectionCounts res;
+
+    // Pending events for separated pairs would otherwise pile up in the queue
+    bool adjacent_pairs_only = std::exchange(options.adjacent_pairs_only, true);
+    sink = {};
+    counts = &res;
+    run();
+    counts = nullptr;
+    options.adjacent_pairs_only = adjacent_pairs_only;
+
+    return res;
+}
+
+template <typename Queue>
+DS::generator<Intersection> BasicLineSweep<Queue>::intersections() {
+    // handleEventPoint reports at most one intersection per event point. The
+    // guard is destroyed with the coroutine frame when the consumer stops early.
+    std::optional<Intersection> found;
+    sink_guard guard(sink, {&found, [](void* ctx, const Intersection& intersection) { *static_cast<std::optional<Intersection>*>(ctx) = intersection; }});
+
+    while (auto e = q.next()) {
+        handleEventPoint(e);
+        q.recycle(e);
+
+        if (found) {
+            co_yield *found;
+            found.reset();
+        }
+    }
+}
+
+template <typename Queue>
+std::optional<std::pair<segment_id_t, segment_id_t>> BasicLineSweep<Queue>::find_any_intersection() {
+    auto intersect = [&](segment_id_t l, segment_id_t r) {
+        return l != SegmentStore::npos and r != SegmentStore::npos and
+               segment_t::does_intersect(segments.segment(l), segments.segment(r));
+    };
+
+    while (auto e = q.next()) {
+        // Segments sharing an endpoint touch there
+        if (e->lower.size() + e->upper.size() > 1) {
+            e->lower.insert(e->lower.end(), e->upper.begin(), e->upper.end());
+            return std::make_pair(e->lower[0], e->lower[1]);
+        }
+
+        // Up to the first intersection the Status order is consistent, so
+        // one of the pairs that become adjacent meets there first
+        if (e->upper.size()) {
+            segment_id_t seg = e->upper[0], left = status.left(seg), right = status.right(seg);
+            status.erase(seg);
+            if (intersect(left, right)) return std::make_pair(left, right);
+        } else {
+            segment_id_t seg = e->lower[0];
+            sweep_line.move_to(e->pt.y - EPS);
+            status.insert(seg);
+
+            if (segment_id_t left = status.left(seg); intersect(left, seg)) return std::make_pair(left, seg);
+            if (segment_id_t right = status.right(seg); intersect(seg, right)) return std::make_pair(seg, right);
+        }
+
+        q.recycle(e);
     }
+
+    return std::nullopt;
 }
 
-void LineSweep::find_intersections() {
-    while (!q.empty()) {
+template <typename Queue>
+bool BasicLineSweep<Queue>::run() {
+    using clock = std::chrono::steady_clock;
+
+    reported = 0;
+    stopped_early = false;
+    handled_events.store(0, std::memory_order_relaxed);
+    found_intersections.store(0, std::memory_order_relaxed);
+
+    auto until = deadline;
+    if (options.time_limit != clock::duration::max()) until = std::min(until, clock::now() + options.time_limit);
+
+    bool timed = until != clock::time_point::max();
+    std::size_t check_every = std::max<std::size_t>(options.check_every, 1);
+
+    for (std::size_t handled = 1;; handled++) {
+        // An event reports at most one intersection, so stopping before the
+        // next one never goes over the budget
+        if (reported >= options.max_intersections) {
+            stopped_early = !q.empty();
+            break;
+        }
+
         auto e = q.next();
+        if (e == nullptr) break;
+
         handleEventPoint(e);
+        q.recycle(e);
         // Recalculate the relative_loc for comparable segments in status when encountering the top pt of a new segment?
+
+        handled_events.store(handled, std::memory_order_relaxed);
+        found_intersections.store(reported, std::memory_order_relaxed);
+        current_y.store(sweep_line.y, std::memory_order_relaxed);
+
+        bool check = handled % check_every == 0;
+        if ((check and timed and clock::now() >= until) or (check and stop_token.stop_requested())) {
+            stopped_early = !q.empty();
+            break;
+        }
     }
+
+    return !stopped_early;
 }
 
-void LineSweep::handleEventPoint(Event* e) {
-    sweep_line_y = e->pt->y;
+template <typename Queue>
+void BasicLineSweep<Queue>::handleEventPoint(Event* e) {
+    sweep_line.move_to(e->pt.y);
 
 #ifdef DEBUG
-    std::cout << "Handling Event Point: " << *e->pt << "\n";
+    std::cout << "Handling Event Point: " << e->pt << "\n";
 
     std::cout << "lower: ";
-    for (const auto& seg : e->lower) std::cout << *seg << "\t";
+    for (auto seg : e->lower) std::cout << segments.segment(seg) << "\t";
     std::cout << "\n";
 
     std::cout << "contain: ";
-    for (const auto& seg : e->contain) std::cout << *seg << "\t";
+    for (auto seg : e->contain) std::cout << segments.segment(seg) << "\t";
     std::cout << "\n";
 
     std::cout << "upper: ";
-    for (const auto& seg : e->upper) std::cout << *seg << "\t";
+    for (auto seg : e->upper) std::cout << segments.segment(seg) << "\t";
     std::cout << "\n------------------------------\n";
 #endif
 
-    int total_size = e->lower.size() + e->upper.size() + e->contain.size();
-    if (total_size > 1) {
-        Intersection I;
-        I.pt = *e->pt;
-        for (const auto& comparableSeg : e->lower) {
-            I.segs.push_back(*comparableSeg);
-        }
+    // Neighbours only report where they cross each other. Segments that
+    // start or end in the interior of another, and collinear segments tied
+    // with one that does cross, are picked up from the status around p,
+    // walking out from a segment at p if one is in it already.
+    Status::iterator start;
+    if (e->upper.size() or e->contain.size())
+        start = status.handle(e->upper.size() ? e->upper[0] : e->contain[0]);
+    else
+        start = status.upper_bound(SweepKey(e->pt.x - EPS, e->pt.y));
 
-        for (const auto& comparableSeg : e->upper) {
-            I.segs.push_back(*comparableSeg);
-        }
+    auto near_p = [&](Status::iterator it) { return std::abs(it->key.x_at(sweep_line) - e->pt.x) <= EPS; };
+    auto add_through = [&](segment_id_t seg) {
+        if (e->pt != segments.u(seg) and e->pt != segments.v(seg)) e->contain.push_back(seg);
+    };
 
-        for (const auto& comparableSeg : e->contain) {
-            I.segs.push_back(*comparableSeg);
-        }
+    for (auto it = start; it != status.end() and near_p(it); ++it) add_through(it->val);
+    for (auto it = start; it != status.begin() and near_p(std::prev(it)); --it) add_through(std::prev(it)->val);
+
+    // Intersection events may name the same segment once per adjacent pair
+    std::sort(e->contain.begin(), e->contain.end());
+    e->contain.erase(std::unique(e->contain.begin(), e->contain.end()), e->contain.end());
+
+    std::size_t total_size = e->lower.size() + e->upper.size() + e->contain.size();
+    std::size_t pairs = total_size * (total_size - 1) / 2;
+    if (segments.colored() and total_size > 1) {
+        std::size_t reds = 0;
+        for (const auto* list : {&e->lower, &e->upper, &e->contain})
+            for (auto seg : *list) reds += segments.color(seg) == SegmentColor::red;
 
-        intersections.push_back(I);
+        pairs = reds * (total_size - reds);
+    }
+
+    if (pairs > 0) {
+        reported++;
+        if (counts) {
+            counts->points++;
+            counts->pairs += pairs;
+        } else if (sink.call) {
+            report_ids.clear();
+            report_ids.insert(report_ids.end(), e->lower.begin(), e->lower.end());
+            report_ids.insert(report_ids.end(), e->upper.begin(), e->upper.end());
+            report_ids.insert(report_ids.end(), e->contain.begin(), e->contain.end());
+            sink.call(sink.ctx, Intersection{e->pt, report_ids});
+        } else {
+            results.push_back(e->pt);
+            results.append(e->lower.begin(), e->lower.end());
+            results.append(e->upper.begin(), e->upper.end());
+            results.append(e->contain.begin(), e->contain.end());
+        }
 #ifdef DEBUG
         std::cout << "Found Intersection point: " << e->pt;
         std::cout << "\n------------------------------\n";
@@ -65,78 +276,174 @@ void LineSweep::handleEventPoint(Event* e) {
 #endif
     }
 
-    for (auto comparableSeg : e->lower) {
-        status.erase(*comparableSeg);
+    // Pairs of neighbours about to be separated give up their pending events
+    auto detach = [&](segment_id_t seg) {
+        cancelEvent(status.left(seg), seg, e->pt);
+        cancelEvent(seg, status.right(seg), e->pt);
+    };
+
+    // Delete the segments ending at p by their handles
+    for (auto seg : e->upper) {
+        if (options.adjacent_pairs_only) detach(seg);
+        status.erase(seg);
+    }
+
+    if (options.adjacent_pairs_only) {
+        for (auto seg : e->contain) detach(seg);
+    }
+
+    // Segments passing through p are now adjacent in the Status and swap
+    // their order at p, which reverses the run without touching the tree shape.
+    auto in_contain = [&](segment_id_t seg) {
+        return seg != SegmentStore::npos and std::binary_search(e->contain.begin(), e->contain.end(), seg);
+    };
+
+    // The Status is ordered slightly below l from here on. Removal and
+    // reversal go by handles, so neither compares keys.
+    sweep_line.move_to(e->pt.y - EPS);
+
+    bool reversed = false;
+    segment_id_t leftmost = SegmentStore::npos, rightmost = SegmentStore::npos;
+    if (e->contain.size()) {
+        segment_id_t first = e->contain[0], last = e->contain[0];
+        std::size_t run_size = 1;
+        for (; in_contain(status.left(first)); run_size++) first = status.left(first);
+        for (; in_contain(status.right(last)); run_size++) last = status.right(last);
+
+        // A stray segment within rounding distance of p can split the run.
+        // Nearly concurrent segments cross a few ulps apart instead of at p,
+        // and each of those crossings gathers the whole bundle again, so the
+        // reversal is kept only if it leaves the run in order below p.
+        if (run_size == e->contain.size()) {
+            status.reverse(first, last);
+            reversed = status.ordered(last, first);
+        }
+
+        if (reversed) {
+            leftmost = last;
+            rightmost = first;
+        } else {
+            for (auto seg : e->contain) {
+                status.erase(seg);
+            }
+        }
     }
 
-    for (const auto& comparableSeg : e->contain) {
-        status.erase(*comparableSeg);
+    // Insert the segments starting at p in their order slightly below l
+    auto insert_and_track = [&](segment_id_t seg) {
+        status.insert(seg);
+        if (options.adjacent_pairs_only) cancelEvent(status.left(seg), status.right(seg), e->pt);
+
+        if (leftmost == SegmentStore::npos or status.less(seg, leftmost)) leftmost = seg;
+        if (rightmost == SegmentStore::npos or status.less(rightmost, seg)) rightmost = seg;
+    };
+
+    for (auto seg : e->lower) {
+        insert_and_track(seg);
     }
 
-    // Insert U(p) | C(p) into Status in their order slightly below l
-    sweep_line_y += 2 * EPS;
-    for (auto& comparableSeg : e->upper) {
-        status.insert(comparableSeg);
+    if (!reversed) {
+        for (auto seg : e->contain) {
+            insert_and_track(seg);
+        }
     }
 
-    for (auto& comparableSeg : e->contain) {
-        status.insert(comparableSeg);
+    // Collinear segments tie below p, so one of them may have landed beyond the extremes
+    if (leftmost != SegmentStore::npos) {
+        auto inserted = [&](segment_id_t seg) {
+            return in_contain(seg) or std::find(e->lower.begin(), e->lower.end(), seg) != e->lower.end();
+        };
+
+        while (inserted(status.left(leftmost))) leftmost = status.left(leftmost);
+        while (inserted(status.right(rightmost))) rightmost = status.right(rightmost);
     }
 
-    if (e->upper.size() + e->contain.size() == 0) {
-        // This must mean that p is a lower point only,
-        // and not the upper point or intersection point of any segment
-        // So, Get Left and Right neighbour to check
+    if (leftmost == SegmentStore::npos) {
+        // Segments only end at p, and every segment through p is in contain,
+        // so the neighbours of p at its own y are those left and right of it
+        sweep_line.move_to(e->pt.y);
+        SweepKey probe(e->pt.x, e->pt.y);
 
-        auto rightNeighbour = status.upper_bound(ComparableSegment(*e->pt, *e->pt, &sweep_line_y));
-        auto leftNeighbour = rightNeighbour--;  // TODO: Check if the predecssor exists?
+        auto rightNeighbour = status.upper_bound(probe);
+        if (rightNeighbour == status.begin() or rightNeighbour == status.end()) return;
 
-        findNewEvent(leftNeighbour, rightNeighbour, e->pt);
+        auto leftNeighbour = std::prev(rightNeighbour);
+        findNewEvent(leftNeighbour->val, rightNeighbour->val, e->pt);
     } else {
-        ComparableSegment leftmost, rightmost;
-        if (e->upper.size()) {
-            leftmost = *(e->upper[0]);
-            rightmost = *(e->upper[0]);
-        } else {
-            leftmost = *(e->contain[0]);
-            rightmost = *(e->contain[0]);
+        if (auto leftNeighbour = status.left(leftmost); leftNeighbour != SegmentStore::npos) {
+            findNewEvent(leftNeighbour, leftmost, e->pt);
         }
 
-        for (const auto& seg : e->upper) {
-            auto leftmost_intersection = segment_t::compute_intersection(leftmost, e->pt->y);
-            auto rightmost_intersection = segment_t::compute_intersection(rightmost, e->pt->y);
-            auto seg_intersection = segment_t::compute_intersection(*seg, e->pt->y);
-
-            if (seg_intersection.x < leftmost_intersection.x) leftmost = *seg;
-            if (seg_intersection.x > rightmost_intersection.x) rightmost = *seg;
+        if (auto rightNeighbour = status.right(rightmost); rightNeighbour != SegmentStore::npos) {
+            findNewEvent(rightmost, rightNeighbour, e->pt);
         }
+    }
+}
+
+static bool is_parallel(const segment_t& l1, const segment_t& l2) {
+    return (l1.v.x - l1.u.x) * (l2.v.y - l2.u.y) == (l1.v.y - l1.u.y) * (l2.v.x - l2.u.x);
+}
 
-        for (const auto& seg : e->contain) {
-            // Move the leftmost and rightmost segments slightly to get the correct items
-            auto leftmost_intersection = segment_t::compute_intersection(leftmost, e->pt->y);
-            auto rightmost_intersection = segment_t::compute_intersection(rightmost, e->pt->y);
-            auto seg_intersection = segment_t::compute_intersection(*seg, e->pt->y);
+template <typename Queue>
+void BasicLineSweep<Queue>::findNewEvent(segment_id_t leftNeighbour, segment_id_t rightNeighbour, const point_t& pt) {
+    if (options.colors_noncrossing and segments.colored() and
+        segments.color(leftNeighbour) == segments.color(rightNeighbour)) return;
 
-            if (seg_intersection.x < leftmost_intersection.x) leftmost = *seg;
-            if (seg_intersection.x > rightmost_intersection.x) rightmost = *seg;
+    segment_t left = segments.segment(leftNeighbour), right = segments.segment(rightNeighbour);
+
+    if (!segment_t::does_intersect(left, right)) return;
+    if (is_parallel(left, right)) return;  // Collinear overlaps are found in the status at their ends
+
+    point_t intersection = segment_t::compute_intersection(left, right);
+    if (intersection == point_t()) return;
+
+    // Snap to an endpoint so that touching segments share the endpoint event
+    for (const auto& endpoint : {left.u, left.v, right.u, right.v}) {
+        if (std::abs(endpoint.x - intersection.x) <= EPS and std::abs(endpoint.y - intersection.y) <= EPS) {
+            intersection = endpoint;
+            break;
         }
+    }
+
+    // Only intersections below the sweep line or on it to the right of the event point are new
+    if (!(pt < intersection)) return;
 
-        auto leftNeighbour = status.upper_bound(leftmost);    // --leftNeighbour;
-        auto rightNeighbour = status.upper_bound(rightmost);  // --rightNeighbour;
+    // The second segment goes straight into the event the queue returned
+    Event* e = nullptr;
+    for (auto seg : {leftNeighbour, rightNeighbour}) {
+        if (intersection == segments.u(seg) or intersection == segments.v(seg)) continue;
 
-        findNewEvent(leftNeighbour, rightNeighbour, e->pt);
+        if (e == nullptr)
+            e = q.insert(intersection, seg, 2);
+        else
+            e->add(seg, 2);
     }
+
+    if (e == nullptr) return;  // Both segments end there, the endpoint event covers it
+
+    if (options.adjacent_pairs_only) segments.pending(leftNeighbour) = e;
 }
 
-void LineSweep::findNewEvent(ComparableSegment* leftNeighbour, ComparableSegment* rightNeighbour, point_t* pt) {
-    if (!segment_t::does_intersect(*leftNeighbour, *rightNeighbour)) return;
-    point_t intersection = segment_t::compute_intersection(*leftNeighbour, *rightNeighbour);
+template <typename Queue>
+void BasicLineSweep<Queue>::cancelEvent(segment_id_t leftNeighbour, segment_id_t rightNeighbour, const point_t& pt) {
+    if (leftNeighbour == SegmentStore::npos or segments.pending(leftNeighbour) == nullptr) return;
+
+    Event* e = std::exchange(segments.pending(leftNeighbour), nullptr);
+    if (e->pt == pt) return;  // Being handled right now
+
+    // Undo exactly what findNewEvent added for this pair
+    for (auto seg : {leftNeighbour, rightNeighbour}) {
+        if (e->pt == segments.u(seg) or e->pt == segments.v(seg)) continue;
 
-    // If intersection is below sweep_line or to the right of the event point
-    if ((intersection.y < sweep_line_y) or (intersection.x > pt->x)) {
-        if (q.search(intersection) != q.end()) {
-            if (*pt != leftNeighbour->u and *pt != leftNeighbour->v) q.insert(*pt, new Event(pt, leftNeighbour, 2));
-            if (*pt != rightNeighbour->u and *pt != rightNeighbour->v) q.insert(*pt, new Event(pt, rightNeighbour, 2));
+        auto it = std::find(e->contain.begin(), e->contain.end(), seg);
+        if (it != e->contain.end()) {
+            *it = e->contain.back();
+            e->contain.pop_back();
         }
     }
-}
\ No newline at end of file
+
+    if (e->empty()) q.discard(e);
+}
+
+template class BasicLineSweep<EventQueue>;
+template class BasicLineSweep<HeapEventQueue>;
@@ -1,17 +1,89 @@
 #include <gtest/gtest.h>
 
 #include <event_queue.hpp>
+#include <heap_event_queue.hpp>
+#include <memory_resource>
+#include <vector>
 
+class EventQueueTest : public ::testing::Test {};
 
-// class EventQueueTest: public ::testing::Test {
-//     protected:
-//     void SetUp() override {
+TEST_F(EventQueueTest, BuildMergesCoincidentEndpoints) {
+    std::vector<segment_t> input{segment_t(point_t(0, 2), point_t(1, 0)),
+                                 segment_t(point_t(1, 0), point_t(3, -1)),
+                                 segment_t(point_t(2, 2), point_t(1, 0))};
+    SegmentStore segments;
+    segments.assign(input);
 
-//     }
+    std::pmr::monotonic_buffer_resource arena;
+    EventQueue q(&arena);
+    q.build(segments);
 
-//     EventQueue* eq;
-// };
+    // Events come out top to bottom, left to right
+    Event* e = q.next();
+    ASSERT_EQ(e->pt, point_t(0, 2));
+    ASSERT_EQ(e->lower.size(), 1);
 
-// TEST_F(EventQueueTest, AddEventToQueue) {
-    
-// }
\ No newline at end of file
+    e = q.next();
+    ASSERT_EQ(e->pt, point_t(2, 2));
+
+    e = q.next();
+    ASSERT_EQ(e->pt, point_t(1, 0));
+    ASSERT_EQ(e->lower.size(), 1);
+    ASSERT_EQ(e->upper.size(), 2);
+
+    e = q.next();
+    ASSERT_EQ(e->pt, point_t(3, -1));
+    ASSERT_TRUE(q.empty());
+}
+
+TEST_F(EventQueueTest, HeapQueueMergesIntersections) {
+    std::vector<segment_t> input{segment_t(point_t(0, 2), point_t(2, 0)),
+                                 segment_t(point_t(2, 2), point_t(0, 0)),
+                                 segment_t(point_t(1, 3), point_t(1, -1))};
+    SegmentStore segments;
+    segments.assign(input);
+    segment_id_t a = 0, b = 1, c = 2;
+
+    std::pmr::monotonic_buffer_resource arena;
+    HeapEventQueue q(&arena);
+    q.build(segments);
+
+    // The same crossing reported by two pairs, plus one at an endpoint
+    q.insert(point_t(1, 1), a, 2);
+    q.insert(point_t(1, 1), c, 2);
+    q.insert(point_t(1, 1), b, 2);
+    q.insert(point_t(2, 0), c, 2);
+
+    std::vector<point_t> order;
+    while (!q.empty()) {
+        Event* e = q.next();
+        order.push_back(e->pt);
+        if (e->pt == point_t(1, 1)) {
+            ASSERT_EQ(e->contain.size(), 3);
+        }
+        if (e->pt == point_t(2, 0)) {
+            ASSERT_EQ(e->upper.size(), 1);
+            ASSERT_EQ(e->contain.size(), 1);
+        }
+    }
+
+    std::vector<point_t> expected{point_t(1, 3), point_t(0, 2), point_t(2, 2), point_t(1, 1),
+                                  point_t(0, 0), point_t(2, 0), point_t(1, -1)};
+    ASSERT_EQ(order, expected);
+}
+
+TEST_F(EventQueueTest, InsertAppendsToExistingEvent) {
+    segment_id_t a = 0, b = 1;
+
+    std::pmr::monotonic_buffer_resource arena;
+    EventQueue q(&arena);
+    Event* e = q.insert(point_t(1, 1), a, 2);
+    ASSERT_EQ(q.insert(point_t(1, 1), b, 2), e);
+    Event* end = q.insert(point_t(2, 0), a, 1);
+    ASSERT_EQ(q.search(point_t(2, 0))->val, end);
+
+    ASSERT_EQ(q.next(), e);
+    ASSERT_EQ(e->contain.size(), 2);
+    ASSERT_EQ(q.next()->upper.size(), 1);
+    ASSERT_TRUE(q.empty());
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <generator.hpp>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+class GeneratorTest : public ::testing::Test {
+   protected:
+    static DS::generator<int> iota(int n, int* produced) {
+        for (int i = 0; i < n; i++) {
+            co_yield i;
+            (*produced)++;
+        }
+    }
+
+    static DS::generator<int> failing() {
+        co_yield 1;
+        throw std::runtime_error("failed");
+    }
+};
+
+TEST_F(GeneratorTest, YieldsInOrder) {
+    int produced = 0;
+    std::vector<int> values;
+    for (int val : iota(5, &produced)) values.push_back(val);
+
+    ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4}));
+    ASSERT_EQ(produced, 5);
+}
+
+TEST_F(GeneratorTest, RunsLazily) {
+    int produced = 0;
+    auto gen = iota(1000, &produced);
+    ASSERT_EQ(produced, 0);
+
+    std::vector<int> values;
+    for (int val : std::move(gen) | std::views::filter([](int val) { return val % 2; }) | std::views::take(3)) values.push_back(val);
+
+    ASSERT_EQ(values, (std::vector<int>{1, 3, 5}));
+    ASSERT_LT(produced, 10);  // Only as far as the pipeline pulled
+}
+
+TEST_F(GeneratorTest, RethrowsExceptions) {
+    auto gen = failing();
+    auto it = gen.begin();
+    ASSERT_EQ(*it, 1);
+    ASSERT_THROW(++it, std::runtime_error);
+}
@@ -0,0 +1,606 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <line_sweep.hpp>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <stop_token>
+#include <vector>
+
+class LineSweepTest : public ::testing::Test {
+   protected:
+    static std::vector<segment_t> random_segments(std::size_t n, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> coord(0, 100);
+
+        std::vector<segment_t> segs;
+        for (std::size_t i = 0; i < n; i++) segs.emplace_back(coord(gen), coord(gen), coord(gen), coord(gen));
+        return segs;
+    }
+
+    // Number of crossing pairs, which is the number of intersection points in general position
+    static std::size_t brute_force_count(const std::vector<segment_t>& segs) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < segs.size(); i++)
+            for (std::size_t j = i + 1; j < segs.size(); j++)
+                if (segment_t::does_intersect(segs[i], segs[j])) count++;
+        return count;
+    }
+
+    // Number of distinct pairs that meet at one of the reported points
+    static std::size_t distinct_pairs(const IntersectionSet& intersections) {
+        std::vector<std::pair<segment_id_t, segment_id_t>> pairs;
+        for (auto intersection : intersections)
+            for (auto i : intersection.ids)
+                for (auto j : intersection.ids)
+                    if (i < j) pairs.emplace_back(i, j);
+
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        return pairs.size();
+    }
+};
+
+TEST_F(LineSweepTest, NoIntersection) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(1, 2, 3, 4);
+    segs.emplace_back(2, 1, 4, 3);
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+    ASSERT_EQ(sweep.getIntersections().size(), 0);
+}
+
+TEST_F(LineSweepTest, SingleCrossing) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(0, 0, 2, 2);
+    segs.emplace_back(0, 2, 2, 0);
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+
+    auto intersections = sweep.getIntersections();
+    ASSERT_EQ(intersections.size(), 1);
+    ASSERT_DOUBLE_EQ(intersections[0].pt.x, 1);
+    ASSERT_DOUBLE_EQ(intersections[0].pt.y, 1);
+    ASSERT_EQ(intersections[0].ids.size(), 2);
+
+    // Ids index into the input
+    std::vector<segment_id_t> ids(intersections[0].ids.begin(), intersections[0].ids.end());
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(ids, (std::vector<segment_id_t>{0, 1}));
+}
+
+TEST_F(LineSweepTest, SharedEndpointAndTJunction) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(0, 4, 2, 0);  // Shares (2, 0) with the next segment
+    segs.emplace_back(4, 4, 2, 0);
+    segs.emplace_back(1, 2, 3.5, 3);  // Both endpoints lie on the segments above
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+
+    // (3.5, 3), (1, 2), (2, 0)
+    ASSERT_EQ(sweep.getIntersections().size(), 3);
+}
+
+TEST_F(LineSweepTest, ThreeSegmentsThroughOnePoint) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(-1, 1, 1, -1);
+    segs.emplace_back(0, 2, 0, -2);
+    segs.emplace_back(-1, -1, 1, 1);
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+
+    auto intersections = sweep.getIntersections();
+    ASSERT_EQ(intersections.size(), 1);
+    ASSERT_EQ(intersections[0].ids.size(), 3);
+}
+
+TEST_F(LineSweepTest, CollinearOverlap) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(0, 6, 3, 3);
+    segs.emplace_back(2, 4, 5, 1);  // On the same line, overlapping from (2, 4) to (3, 3)
+    segs.emplace_back(4, 6, 2, 1);  // Crosses both inside the overlap
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+
+    // Both ends of the overlap, and the crossing with all three segments
+    auto intersections = sweep.getIntersections();
+    ASSERT_EQ(intersections.size(), 3);
+    ASSERT_EQ(intersections[0].pt, point_t(2, 4));
+    ASSERT_EQ(intersections[1].ids.size(), 3);
+    ASSERT_EQ(intersections[2].pt, point_t(3, 3));
+}
+
+TEST_F(LineSweepTest, IntegerGridAgainstBruteForce) {
+    // Shared endpoints, T-junctions and collinear overlaps everywhere
+    for (unsigned seed = 0; seed < 200; seed++) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> coord(0, 5);
+
+        std::vector<segment_t> segs;
+        while (segs.size() < 15) {
+            point_t u(coord(gen), coord(gen)), v(coord(gen), coord(gen));
+            if (u.y != v.y) segs.emplace_back(u, v);
+        }
+
+        for (bool adjacent_pairs_only : {false, true}) {
+            SweepOptions options;
+            options.adjacent_pairs_only = adjacent_pairs_only;
+
+            LineSweep sweep(segs, options);
+            sweep.find_intersections();
+
+            // Every intersecting pair meets at one of the reported points
+            ASSERT_EQ(distinct_pairs(sweep.getIntersections()), brute_force_count(segs)) << "seed " << seed;
+        }
+    }
+}
+
+TEST_F(LineSweepTest, RandomAgainstBruteForce) {
+    for (unsigned seed = 0; seed < 20; seed++) {
+        auto segs = random_segments(100, seed);
+
+        LineSweep sweep(segs);
+        sweep.find_intersections();
+        ASSERT_EQ(sweep.getIntersections().size(), brute_force_count(segs)) << "seed " << seed;
+    }
+}
+
+TEST_F(LineSweepTest, ManySegmentsThroughOnePoint) {
+    // A star through (50, 50) mixed with random segments. Counting pairs
+    // per intersection checks the order of the star after it is reversed.
+    auto segs = random_segments(60, 42);
+    for (int i = 0; i < 40; i++) {
+        double dx = 10 + i, dy = 37 - 2 * i + 0.5;
+        segs.emplace_back(50 - dx, 50 - dy, 50 + dx, 50 + dy);
+    }
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+
+    std::size_t pairs = 0;
+    for (const auto& intersection : sweep.getIntersections())
+        pairs += intersection.ids.size() * (intersection.ids.size() - 1) / 2;
+
+    ASSERT_EQ(pairs, brute_force_count(segs));
+
+    // Slopes that are not exact put the crossings of a star a few ulps
+    // apart, each one its own event point gathering the whole star
+    for (unsigned seed = 0; seed < 20; seed++) {
+        auto segs = random_segments(80, seed);
+
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> angle(0.1, 3), length(5, 50);
+        for (int i = 0; i < 10; i++) {
+            double t = angle(gen), l = length(gen);
+            segs.emplace_back(50 - l * std::cos(t), 50 - l * std::sin(t), 50 + l * std::cos(t), 50 + l * std::sin(t));
+        }
+
+        LineSweep sweep(segs);
+        sweep.find_intersections();
+        ASSERT_EQ(distinct_pairs(sweep.getIntersections()), brute_force_count(segs)) << "seed " << seed;
+
+        HeapLineSweep heap_sweep(segs);
+        heap_sweep.find_intersections();
+        ASSERT_EQ(distinct_pairs(heap_sweep.getIntersections()), brute_force_count(segs)) << "seed " << seed;
+    }
+}
+
+TEST_F(LineSweepTest, NearlyConcurrentSegments) {
+    // Each pair crosses within a few ulps of the others
+    std::vector<segment_t> segs;
+    segs.emplace_back(5.4544444306594393, 7.1105846065612131, 4.5455555693405607, 2.8894153934387874);
+    segs.emplace_back(7.2221620723776914, 7.017053318434562, 2.7778379276223086, 2.982946681565438);
+    segs.emplace_back(6.0255581335542798, 5.257484638932115, 3.9744418664457202, 4.742515361067885);
+    segs.emplace_back(0.41272563943130336, 8.5992408195488697, 6.2975761331049798, 2.1950099911483028);
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+    ASSERT_EQ(distinct_pairs(sweep.getIntersections()), brute_force_count(segs));
+
+    HeapLineSweep heap_sweep(segs);
+    heap_sweep.find_intersections();
+    ASSERT_EQ(distinct_pairs(heap_sweep.getIntersections()), brute_force_count(segs));
+}
+
+TEST_F(LineSweepTest, HeapQueueAgainstBruteForce) {
+    for (unsigned seed = 0; seed < 20; seed++) {
+        auto segs = random_segments(100, seed);
+
+        HeapLineSweep sweep(segs);
+        sweep.find_intersections();
+        ASSERT_EQ(sweep.getIntersections().size(), brute_force_count(segs)) << "seed " << seed;
+    }
+}
+
+TEST_F(LineSweepTest, AdjacentPairsOnlyAgainstBruteForce) {
+    SweepOptions options;
+    options.adjacent_pairs_only = true;
+
+    for (unsigned seed = 0; seed < 20; seed++) {
+        auto segs = random_segments(100, seed);
+
+        LineSweep sweep(segs, options);
+        sweep.find_intersections();
+        ASSERT_EQ(sweep.getIntersections().size(), brute_force_count(segs)) << "seed " << seed;
+
+        HeapLineSweep heap_sweep(segs, options);
+        heap_sweep.find_intersections();
+        ASSERT_EQ(heap_sweep.getIntersections().size(), brute_force_count(segs)) << "seed " << seed;
+    }
+}
+
+TEST_F(LineSweepTest, ResultsInCompressedRows) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(-1, 1, 1, -1);
+    segs.emplace_back(0, 2, 0, -2);
+    segs.emplace_back(-1, -1, 1, 1);
+    segs.emplace_back(1, 2, 0, 0);  // Ends at (0, 0) where the three above cross
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+
+    const auto& intersections = sweep.getIntersections();
+    ASSERT_EQ(intersections.size(), 1);
+    ASSERT_EQ(intersections.points().size(), 1);
+    ASSERT_EQ(intersections.offsets().size(), 2);
+    ASSERT_EQ(intersections.offsets()[0], 0);
+    ASSERT_EQ(intersections.offsets()[1], 4);
+    ASSERT_EQ(intersections.ids().size(), 4);
+    ASSERT_EQ(intersections[0].ids.data(), intersections.ids().data());
+}
+
+TEST_F(LineSweepTest, StreamsToVisitor) {
+    for (unsigned seed = 0; seed < 5; seed++) {
+        auto segs = random_segments(100, seed);
+
+        LineSweep sweep(segs);
+        std::size_t count = 0, pairs = 0;
+        sweep.find_intersections([&](const Intersection& intersection) {
+            count++;
+            pairs += intersection.ids.size() * (intersection.ids.size() - 1) / 2;
+        });
+
+        ASSERT_EQ(count, brute_force_count(segs)) << "seed " << seed;
+        ASSERT_EQ(pairs, brute_force_count(segs)) << "seed " << seed;
+        ASSERT_EQ(sweep.intersectionCount(), 0);  // Nothing was buffered
+    }
+}
+
+TEST_F(LineSweepTest, VisitorThrows) {
+    auto segs = random_segments(100, 0);
+
+    LineSweep sweep(segs);
+    ASSERT_THROW(sweep.find_intersections([](const Intersection&) { throw std::runtime_error("stop"); }), std::runtime_error);
+
+    // The sweep is left midway but can start over
+    sweep.reset(segs);
+    sweep.find_intersections();
+    ASSERT_EQ(sweep.intersectionCount(), brute_force_count(segs));
+}
+
+TEST_F(LineSweepTest, CountOnly) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(-1, 1, 1, -1);
+    segs.emplace_back(0, 2, 0, -2);
+    segs.emplace_back(-1, -1, 1, 1);
+
+    LineSweep sweep(segs);
+    auto counts = sweep.count_intersections();
+    ASSERT_EQ(counts.points, 1);
+    ASSERT_EQ(counts.pairs, 3);
+    ASSERT_EQ(sweep.intersectionCount(), 0);
+
+    for (unsigned seed = 0; seed < 5; seed++) {
+        auto segs = random_segments(200, seed);
+
+        LineSweep tree_sweep(segs);
+        HeapLineSweep heap_sweep(segs);
+        for (auto counts : {tree_sweep.count_intersections(), heap_sweep.count_intersections()}) {
+            ASSERT_EQ(counts.points, brute_force_count(segs)) << "seed " << seed;
+            ASSERT_EQ(counts.pairs, brute_force_count(segs)) << "seed " << seed;
+        }
+    }
+}
+
+TEST_F(LineSweepTest, AnyIntersection) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(1, 2, 3, 4);
+    segs.emplace_back(2, 1, 4, 3);
+
+    LineSweep sweep(segs);
+    ASSERT_FALSE(sweep.find_any_intersection());
+
+    // Touching at an endpoint counts
+    segs.emplace_back(3, 4, 5, 0);
+    sweep.reset(segs);
+    ASSERT_TRUE(sweep.find_any_intersection());
+
+    for (unsigned seed = 0; seed < 200; seed++) {
+        auto segs = random_segments(6, seed);
+
+        sweep.reset(segs);
+        auto witness = sweep.find_any_intersection();
+        ASSERT_EQ(witness.has_value(), brute_force_count(segs) > 0) << "seed " << seed;
+        if (witness) {
+            ASSERT_TRUE(segment_t::does_intersect(segs[witness->first], segs[witness->second])) << "seed " << seed;
+        }
+    }
+}
+
+TEST_F(LineSweepTest, IntersectionBudget) {
+    auto segs = random_segments(100, 3);
+    std::size_t total = brute_force_count(segs);
+    ASSERT_GT(total, 10);
+
+    SweepOptions options;
+    options.max_intersections = 10;
+
+    LineSweep sweep(segs, options);
+    ASSERT_FALSE(sweep.find_intersections());
+    ASSERT_TRUE(sweep.truncated());
+    ASSERT_EQ(sweep.intersectionCount(), 10);
+
+    HeapLineSweep heap_sweep(segs, options);
+    ASSERT_EQ(heap_sweep.count_intersections().points, 10);
+    ASSERT_TRUE(heap_sweep.truncated());
+
+    // A budget that is not reached leaves the result complete
+    options.max_intersections = total + 1;
+    LineSweep full_sweep(segs, options);
+    ASSERT_TRUE(full_sweep.find_intersections());
+    ASSERT_FALSE(full_sweep.truncated());
+    ASSERT_EQ(full_sweep.intersectionCount(), total);
+}
+
+TEST_F(LineSweepTest, ZeroIntersectionBudget) {
+    std::vector<segment_t> segs;
+    segs.emplace_back(1, 2, 0, 0);
+    segs.emplace_back(1, 2, 2, 0);
+    segs.emplace_back(0, 1, 2, 1.5);
+
+    SweepOptions options;
+    options.max_intersections = 0;
+
+    LineSweep sweep(segs, options);
+    ASSERT_FALSE(sweep.find_intersections());
+    ASSERT_TRUE(sweep.truncated());
+    ASSERT_EQ(sweep.intersectionCount(), 0);
+
+    HeapLineSweep heap_sweep(segs, options);
+    ASSERT_EQ(heap_sweep.count_intersections().points, 0);
+    ASSERT_TRUE(heap_sweep.truncated());
+}
+
+TEST_F(LineSweepTest, TimeBudget) {
+    auto segs = random_segments(500, 4);
+
+    SweepOptions options;
+    options.time_limit = std::chrono::steady_clock::duration::zero();
+
+    LineSweep sweep(segs, options);
+    ASSERT_FALSE(sweep.find_intersections());
+    ASSERT_LT(sweep.intersectionCount(), brute_force_count(segs));
+}
+
+TEST_F(LineSweepTest, LazyIntersections) {
+    auto segs = random_segments(100, 5);
+
+    LineSweep sweep(segs);
+    std::size_t count = 0;
+    for (const auto& intersection : sweep.intersections()) {
+        ASSERT_GE(intersection.ids.size(), 2);
+        count++;
+    }
+    ASSERT_EQ(count, brute_force_count(segs));
+    ASSERT_EQ(sweep.intersectionCount(), 0);
+
+    // Abandoning the generator stops the sweep where it is
+    HeapLineSweep heap_sweep(segs);
+    std::vector<point_t> first;
+    for (const auto& intersection : heap_sweep.intersections() | std::views::take(3)) first.push_back(intersection.pt);
+    ASSERT_EQ(first.size(), 3);
+    ASSERT_TRUE(first[0] < first[1] and first[1] < first[2]);
+
+    heap_sweep.reset(segs);
+    ASSERT_TRUE(heap_sweep.find_intersections());
+    ASSERT_EQ(heap_sweep.intersectionCount(), count);
+}
+
+TEST_F(LineSweepTest, BackgroundSweep) {
+    auto segs = random_segments(200, 6);
+
+    LineSweep sweep(segs);
+    sweep.find_intersections_async().join();
+    ASSERT_FALSE(sweep.truncated());
+    ASSERT_EQ(sweep.intersectionCount(), brute_force_count(segs));
+
+    auto progress = sweep.progress();
+    ASSERT_GE(progress.events, 2 * segs.size() - 1);
+    ASSERT_EQ(progress.intersections, sweep.intersectionCount());
+    ASSERT_DOUBLE_EQ(progress.fraction, 1);
+}
+
+TEST_F(LineSweepTest, BackgroundSweepStops) {
+    // Far more work than the sweep gets to do before it is stopped
+    auto segs = random_segments(3000, 7);
+
+    LineSweep sweep(segs);
+    auto worker = sweep.find_intersections_async();
+    worker.request_stop();
+    worker.join();
+
+    ASSERT_TRUE(sweep.truncated());
+    ASSERT_LT(sweep.progress().fraction, 1);
+
+    // A deadline that has already passed
+    sweep.reset(segs);
+    sweep.find_intersections_async(std::chrono::steady_clock::now()).join();
+    ASSERT_TRUE(sweep.truncated());
+
+    std::stop_source stop;
+    stop.request_stop();
+    sweep.reset(segs);
+    ASSERT_FALSE(sweep.find_intersections(stop.get_token(), std::chrono::steady_clock::time_point::max()));
+    ASSERT_EQ(sweep.progress().events, SweepOptions().check_every);
+}
+
+TEST_F(LineSweepTest, RedBlueAgainstBruteForce) {
+    for (unsigned seed = 0; seed < 10; seed++) {
+        auto segs = random_segments(100, seed);
+
+        std::mt19937 gen(seed);
+        std::vector<SegmentColor> colors;
+        for (std::size_t i = 0; i < segs.size(); i++) colors.push_back(gen() % 2 ? SegmentColor::red : SegmentColor::blue);
+
+        std::size_t expected = 0;
+        for (std::size_t i = 0; i < segs.size(); i++)
+            for (std::size_t j = i + 1; j < segs.size(); j++)
+                if (colors[i] != colors[j] and segment_t::does_intersect(segs[i], segs[j])) expected++;
+
+        LineSweep sweep(segs, colors);
+        sweep.find_intersections();
+        ASSERT_EQ(sweep.intersectionCount(), expected) << "seed " << seed;
+
+        HeapLineSweep heap_sweep(segs, colors);
+        ASSERT_EQ(heap_sweep.count_intersections().pairs, expected) << "seed " << seed;
+    }
+}
+
+TEST_F(LineSweepTest, RedBlueNoncrossingLayers) {
+    // Two grids of parallel segments, every red crossing every blue once
+    std::vector<segment_t> segs;
+    std::vector<SegmentColor> colors;
+    for (int i = 0; i < 20; i++) {
+        segs.emplace_back(i, 0, i + 30, 30);
+        colors.push_back(SegmentColor::red);
+        segs.emplace_back(i + 30, 0, i, 30);
+        colors.push_back(SegmentColor::blue);
+    }
+
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < segs.size(); i++)
+        for (std::size_t j = i + 1; j < segs.size(); j++)
+            if (segment_t::does_intersect(segs[i], segs[j])) expected++;
+
+    SweepOptions options;
+    options.colors_noncrossing = true;
+
+    LineSweep sweep(segs, colors, options);
+    auto counts = sweep.count_intersections();
+    ASSERT_EQ(counts.pairs, expected);
+    ASSERT_EQ(counts.points, expected);
+}
+
+TEST_F(LineSweepTest, RedBlueTouchingLayers) {
+    SweepOptions options;
+    options.colors_noncrossing = true;
+
+    // A blue segment ending on another blue one, and a shared red vertex on a blue segment
+    std::vector<segment_t> segs;
+    segs.emplace_back(0, 3, 3, 0);
+    segs.emplace_back(5, 2, 1, 0);
+    segs.emplace_back(3, 2, 3, 1);
+    segs.emplace_back(6, 4, 7, 2);
+    segs.emplace_back(7, 2, 6, 0);
+    segs.emplace_back(4, 3, 10, 1);
+    std::vector<SegmentColor> colors{SegmentColor::red, SegmentColor::blue, SegmentColor::blue, SegmentColor::red, SegmentColor::red, SegmentColor::blue};
+
+    LineSweep sweep(segs, colors, options);
+    sweep.find_intersections();
+
+    const auto& intersections = sweep.getIntersections();
+    ASSERT_EQ(intersections.size(), 2);
+    ASSERT_EQ(intersections[0].pt, point_t(7, 2));
+    ASSERT_EQ(intersections[0].ids.size(), 3);
+    ASSERT_DOUBLE_EQ(intersections[1].pt.x, 7.0 / 3);
+    ASSERT_DOUBLE_EQ(intersections[1].pt.y, 2.0 / 3);
+
+    // Layers drawn on a small grid touch all the time, but never cross
+    auto crosses = [](const segment_t& l1, const segment_t& l2) {
+        if (!segment_t::does_intersect(l1, l2)) return false;
+        if ((l1.v.x - l1.u.x) * (l2.v.y - l2.u.y) == (l1.v.y - l1.u.y) * (l2.v.x - l2.u.x)) return false;
+
+        point_t pt = segment_t::compute_intersection(l1, l2);
+        return pt != l1.u and pt != l1.v and pt != l2.u and pt != l2.v;
+    };
+
+    for (unsigned seed = 0; seed < 100; seed++) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> coord(0, 6);
+
+        segs.clear();
+        colors.clear();
+        for (auto color : {SegmentColor::red, SegmentColor::blue}) {
+            for (int tries = 0; tries < 200; tries++) {
+                point_t u(coord(gen), coord(gen)), v(coord(gen), coord(gen));
+                if (u.y == v.y) continue;
+
+                segment_t seg(u, v);
+                bool crossing = false;
+                for (std::size_t i = 0; i < segs.size(); i++) crossing |= colors[i] == color and crosses(segs[i], seg);
+
+                if (crossing) continue;
+                segs.push_back(seg);
+                colors.push_back(color);
+            }
+        }
+
+        // The promise only saves work, what is reported stays the same
+        LineSweep checked(segs, colors), promised(segs, colors, options);
+        checked.find_intersections();
+        promised.find_intersections();
+
+        const auto& expected = checked.getIntersections();
+        const auto& found = promised.getIntersections();
+        ASSERT_EQ(found.size(), expected.size()) << "seed " << seed;
+        for (std::size_t i = 0; i < found.size(); i++) {
+            ASSERT_EQ(found[i].pt, expected[i].pt) << "seed " << seed;
+
+            std::vector<segment_id_t> found_ids(found[i].ids.begin(), found[i].ids.end());
+            std::vector<segment_id_t> expected_ids(expected[i].ids.begin(), expected[i].ids.end());
+            std::sort(found_ids.begin(), found_ids.end());
+            std::sort(expected_ids.begin(), expected_ids.end());
+            ASSERT_EQ(found_ids, expected_ids) << "seed " << seed;
+        }
+    }
+}
+
+TEST_F(LineSweepTest, ResetDropsResults) {
+    auto segs = random_segments(100, 7);
+
+    LineSweep sweep(segs);
+    sweep.find_intersections();
+    IntersectionSet intersections = sweep.getIntersections();
+    ASSERT_EQ(intersections.size(), brute_force_count(segs));
+
+    // Copies of the results are independent of the sweep
+    sweep.reset();
+    ASSERT_EQ(sweep.getIntersections().size(), 0);
+    ASSERT_EQ(intersections.size(), brute_force_count(segs));
+    ASSERT_GE(intersections[0].ids.size(), 2);
+}
+
+TEST_F(LineSweepTest, ResetWithNewInput) {
+    LineSweep sweep;
+    HeapLineSweep heap_sweep;
+
+    for (unsigned seed = 0; seed < 10; seed++) {
+        auto segs = random_segments(50 + 10 * seed, seed);
+
+        sweep.reset(segs);
+        sweep.find_intersections();
+        ASSERT_EQ(sweep.intersectionCount(), brute_force_count(segs)) << "seed " << seed;
+
+        heap_sweep.reset(segs);
+        heap_sweep.find_intersections();
+        ASSERT_EQ(heap_sweep.intersectionCount(), brute_force_count(segs)) << "seed " << seed;
+    }
+}
@@ -3,7 +3,9 @@
 #include <line_segment.hpp>
 #include <point.hpp>
 #include <rb_tree.hpp>
+#include <cstdlib>
 #include <set>
+#include <vector>
 
 class RBTreeTest : public ::testing::Test {
    protected:
@@ -69,9 +71,48 @@ TEST_F(RBTreeTest, SearchTest) {
 }
 
 TEST_F(RBTreeTest, MinimumTest) {
+    _tree_int_t tree;
+    ASSERT_EQ(tree.minimum(), tree.end());
+
+    tree.insert(4, 14);
+    tree.insert(2, 12);
+    tree.insert(6, 16);
+    ASSERT_EQ(tree.minimum()->key, 2);
+
+    tree.insert(1, 11);
+    ASSERT_EQ(tree.minimum()->key, 1);
+
+    tree.erase(1);
+    ASSERT_EQ(tree.minimum()->key, 2);
 }
 
 TEST_F(RBTreeTest, MaximumTest) {
+    _tree_int_t tree;
+    ASSERT_EQ(tree.maximum(), tree.end());
+
+    tree.insert(4, 14);
+    tree.insert(2, 12);
+    tree.insert(6, 16);
+    ASSERT_EQ(tree.maximum()->key, 6);
+
+    tree.erase(6);
+    ASSERT_EQ(tree.maximum()->key, 4);
+
+    tree.erase(2);
+    tree.erase(4);
+    ASSERT_EQ(tree.maximum(), tree.end());
+}
+
+TEST_F(RBTreeTest, PopMinTest) {
+    _tree_int_t tree;
+    for (int key : {5, 3, 8, 1, 4, 7, 9, 2, 6}) tree.insert(key, key + 10);
+
+    for (int key = 1; key <= 9; key++) {
+        ASSERT_EQ(tree.minimum()->key, key);
+        ASSERT_EQ(tree.pop_min(), key + 10);
+    }
+    ASSERT_EQ(tree.size(), 0);
+    ASSERT_EQ(tree.minimum(), tree.end());
 }
 
 // TODO: Add More Tests. Especially to lower_bound
@@ -90,3 +131,123 @@ TEST_F(RBTreeTest, LowerBoundTest) {
     ASSERT_EQ(tree.upper_bound(4)->key, 8);
     ASSERT_EQ(tree.lower_bound(4)->key, 4);
 }
+
+TEST_F(RBTreeTest, StdAllocatorTest) {
+    DS::rb_tree::tree_t<int, int, DS::rb_tree::three_way, std::allocator<DS::rb_tree::node_t<int, int>>> tree;
+    for (int i = 0; i < 100; i++) tree.insert(i, i * i);
+    ASSERT_EQ(tree.size(), 100);
+
+    for (int i = 0; i < 100; i += 2) tree.erase(i);
+    ASSERT_EQ(tree.size(), 50);
+    ASSERT_EQ(tree.search(7)->val, 49);
+    ASSERT_EQ(tree.search(8), tree.end());
+}
+
+TEST_F(RBTreeTest, PoolAllocatorReuseTest) {
+    DS::pool_allocator<DS::rb_tree::node_t<int, int>, 4> pool;
+    auto a = pool.allocate(1);
+    auto b = pool.allocate(1);
+    ASSERT_EQ(pool.capacity(), 4);
+
+    pool.deallocate(a, 1);
+    ASSERT_EQ(pool.allocate(1), a);  // Freed slots are handed out first
+
+    pool.deallocate(b, 1);
+    pool.deallocate(a, 1);
+}
+
+TEST_F(RBTreeTest, IteratorTraversalTest) {
+    _tree_int_t tree;
+    ASSERT_EQ(tree.begin(), tree.end());
+
+    for (int key : {5, 3, 8, 1, 4, 7, 9, 2, 6}) tree.insert(key, key + 10);
+
+    int expected = 1;
+    for (auto it = tree.begin(); it != tree.end(); ++it) ASSERT_EQ(it->key, expected++);
+    ASSERT_EQ(expected, 10);
+
+    auto it = tree.end();
+    for (int key = 9; key >= 1; key--) ASSERT_EQ((--it)->key, key);
+    ASSERT_EQ(--it, tree.end());
+}
+
+TEST_F(RBTreeTest, IteratorEraseTest) {
+    _tree_int_t tree;
+    auto four = tree.insert(4, 14);
+    for (int key : {2, 6, 1, 3, 5, 7}) tree.insert(key, key + 10);
+
+    ASSERT_EQ(four->val, 14);
+    ASSERT_EQ(std::prev(four)->key, 3);
+    ASSERT_EQ(std::next(four)->key, 5);
+
+    auto next = tree.erase(four);
+    ASSERT_EQ(next->key, 5);
+    ASSERT_EQ(std::prev(next)->key, 3);
+    ASSERT_EQ(tree.size(), 6);
+
+    ASSERT_EQ(tree.erase(tree.maximum()), tree.end());
+    ASSERT_EQ(tree.maximum()->key, 6);
+}
+
+TEST_F(RBTreeTest, BuildTest) {
+    std::vector<std::pair<int, int>> sorted;
+    for (int key = 0; key < 100; key++) sorted.emplace_back(2 * key, key);
+
+    _tree_int_t tree;
+    tree.build(sorted.begin(), sorted.size());
+    ASSERT_EQ(tree.size(), 100);
+    ASSERT_EQ(tree.minimum()->key, 0);
+    ASSERT_EQ(tree.maximum()->key, 198);
+    ASSERT_EQ(tree.search(42)->val, 21);
+    ASSERT_EQ(tree.upper_bound(41)->key, 42);
+
+    // The built tree keeps working as a red black tree
+    for (int key = 1; key < 200; key += 2) tree.insert(key, -key);
+    for (int key = 0; key < 200; key += 4) tree.erase(key);
+
+    int expected = 1;
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++expected) {
+        if (expected % 4 == 0) ++expected;
+        ASSERT_EQ(it->key, expected);
+    }
+}
+
+TEST_F(RBTreeTest, InsertOrMergeTest) {
+    _tree_int_t tree;
+    int made = 0;
+    auto make = [&]() { return ++made; };
+    auto merge = [](int& val) { val += 100; };
+
+    for (int key : {5, 3, 8, 3, 5, 3}) tree.insert_or_merge(key, make, merge);
+
+    ASSERT_EQ(made, 3);
+    ASSERT_EQ(tree.size(), 3);
+    ASSERT_EQ(tree.search(3)->val, 202);
+    ASSERT_EQ(tree.search(5)->val, 101);
+    ASSERT_EQ(tree.search(8)->val, 3);
+    ASSERT_EQ(tree.minimum()->key, 3);
+    ASSERT_EQ(tree.maximum()->key, 8);
+}
+
+TEST_F(RBTreeTest, StatefulCompareTest) {
+    // Orders keys by their distance from a pivot held outside the tree
+    struct distance_compare {
+        const int* pivot;
+        int operator()(int lhs, int rhs) const { return std::abs(lhs - *pivot) - std::abs(rhs - *pivot); }
+    };
+
+    int pivot = 10;
+    DS::rb_tree::tree_t<int, int, distance_compare> tree(distance_compare{&pivot});
+    for (int key : {4, 13, 10, 18, 7}) tree.insert(key, key);
+
+    std::vector<int> order;
+    for (auto it = tree.begin(); it != tree.end(); ++it) order.push_back(it->val);
+    ASSERT_EQ(order, (std::vector<int>{10, 13, 7, 4, 18}));
+
+    ASSERT_EQ(tree.search(16)->val, 4);
+    ASSERT_EQ(tree.lower_bound(11)->val, 13);
+    ASSERT_EQ(tree.upper_bound(14)->val, 4);
+
+    pivot = 0;
+    ASSERT_EQ(tree.key_comp()(4, 7), -3);
+}
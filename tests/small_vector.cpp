@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <small_vector.hpp>
+#include <utility>
+#include <vector>
+
+class SmallVectorTest : public ::testing::Test {
+   protected:
+    typedef DS::small_vector<int, 2> _small_int_t;
+};
+
+TEST_F(SmallVectorTest, InlineStorage) {
+    _small_int_t vec;
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(sizeof(DS::small_vector<int*, 2>), sizeof(std::vector<int*>));
+
+    vec.push_back(1);
+    vec.push_back(2);
+    ASSERT_EQ(vec.size(), 2);
+    ASSERT_EQ(vec.capacity(), 2);
+    ASSERT_EQ(vec[0], 1);
+    ASSERT_EQ(vec.back(), 2);
+}
+
+TEST_F(SmallVectorTest, SpillsToHeap) {
+    _small_int_t vec;
+    for (int i = 0; i < 100; i++) vec.push_back(i);
+
+    ASSERT_EQ(vec.size(), 100);
+    ASSERT_GE(vec.capacity(), 100);
+    for (int i = 0; i < 100; i++) ASSERT_EQ(vec[i], i);
+
+    vec.pop_back();
+    ASSERT_EQ(vec.back(), 98);
+}
+
+TEST_F(SmallVectorTest, InsertAndErase) {
+    _small_int_t vec;
+    std::vector<int> other{3, 1, 2, 3, 1};
+    vec.insert(vec.end(), other.begin(), other.end());
+    ASSERT_EQ(vec.size(), 5);
+
+    std::sort(vec.begin(), vec.end());
+    vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+    ASSERT_EQ(std::vector<int>(vec.begin(), vec.end()), (std::vector<int>{1, 2, 3}));
+
+    vec.insert(vec.begin() + 1, other.begin(), other.begin() + 2);
+    ASSERT_EQ(std::vector<int>(vec.begin(), vec.end()), (std::vector<int>{1, 3, 1, 2, 3}));
+}
+
+TEST_F(SmallVectorTest, CopyAndMove) {
+    _small_int_t small, large;
+    small.push_back(7);
+    for (int i = 0; i < 10; i++) large.push_back(i);
+
+    _small_int_t small_copy{small}, large_copy{large};
+    ASSERT_EQ(small_copy.size(), 1);
+    ASSERT_EQ(large_copy[9], 9);
+
+    _small_int_t moved{std::move(large)};
+    ASSERT_EQ(moved.size(), 10);
+    ASSERT_TRUE(large.empty());
+
+    moved = small_copy;
+    ASSERT_EQ(moved.size(), 1);
+    ASSERT_EQ(moved[0], 7);
+
+    small_copy = std::move(large_copy);
+    ASSERT_EQ(small_copy.size(), 10);
+}